@@ -9,6 +9,10 @@ void vector_create(vector* v, const size_t elementSize) {
     v->length = 0;
     v->elementSize = elementSize;
     
+    v->dead = NULL;
+    v->deadCount = 0;
+    v->compactRead = v->compactWrite = 0;
+
     v->data = NULL;
     v->data = malloc(v->elementSize * v->capacity);
     v->status = (v->data == NULL) ? (vectorStatus_error_init) : (vectorStatus_success);
@@ -40,6 +44,9 @@ void vector_push(vector* v, const void* item) {
 
     if(v->length >= v->capacity) {
 	internal_vector_resize(v, v->capacity*VECTOR_GROWTH_RATE);
+	if(v->length >= v->capacity) {
+	    return;
+	}
     }
 
     internal_vector_assign(v, (v->length)++, item);
@@ -63,6 +70,7 @@ void vector_pop(vector* v) {
     }
 
     if(v->length > 0) {
+	internal_vector_deadTruncate(v, v->length-1);
 	v->length--;
     }
 }
@@ -75,6 +83,13 @@ void vector_remove(vector* v, const size_t index) {
 
     if(internal_vector_checkIndexBounds(v, index)) {
 	internal_gswap(internal_vector_offset(v, index), internal_vector_offset(v, v->length-1), v->elementSize);
+	if(v->dead != NULL) {
+	    // the swap moves an element across a compaction pass, so the pass is restarted
+	    bool indexDead = vector_isDead(v, index);
+	    internal_vector_setDead(v, index, vector_isDead(v, v->length-1));
+	    internal_vector_setDead(v, v->length-1, indexDead);
+	    v->compactRead = v->compactWrite = 0;
+	}
 	vector_pop(v);
     }
 }
@@ -99,8 +114,12 @@ void vector_free(vector* v) {
     }
 
     free(v->data);
+    free(v->dead);
     
     v->data = NULL;
+    v->dead = NULL;
+    v->deadCount = 0;
+    v->compactRead = v->compactWrite = 0;
     v->length = v->capacity = 0;
     v->status = vectorStatus_freed;
 }
@@ -148,6 +167,7 @@ void vector_copyArr(vector* v, const void* arr, const size_t length) {
 	return;
     }
     
+    internal_vector_deadTruncate(v, 0);
     vector_setLength(v, length);
     v->length = length;
     memcpy(v->data, arr, v->length * v->elementSize);
@@ -177,11 +197,22 @@ void vector_copy(vector* vdest, const vector* vsrc) {
 	return;
     }
     
+    internal_vector_deadTruncate(vdest, 0);
     vdest->elementSize = vsrc->elementSize;
     vector_setLength(vdest, vsrc->length);
     vdest->length = vsrc->length;
 
     memmove(vdest->data, vsrc->data, vsrc->length * vsrc->elementSize);
+
+    if(vsrc->deadCount > 0) {
+	if(!internal_vector_deadReserve(vdest, vdest->capacity)) {
+	    vdest->status = vectorStatus_error_resize;
+	    return;
+	}
+
+	memcpy(vdest->dead, vsrc->dead, internal_vector_deadWords(vsrc->length) * sizeof(uint64_t));
+	vdest->deadCount = vsrc->deadCount;
+    }
     
     vdest->status = vectorStatus_success;
 }
@@ -202,6 +233,19 @@ void vector_pushCopy(vector* vdest, const vector* vsrc) {
     }
     
     memmove((vdest->data + vdest->length * vdest->elementSize), vsrc->data, vsrc->length * vsrc->elementSize);
+
+    if(vsrc->deadCount > 0) {
+	if(!internal_vector_deadReserve(vdest, vdest->capacity)) {
+	    vdest->status = vectorStatus_error_resize;
+	    return;
+	}
+
+	for(size_t i = internal_vector_findBit(vsrc, 0, vsrc->length, true); i < vsrc->length; i = internal_vector_findBit(vsrc, i+1, vsrc->length, true)) {
+	    internal_vector_setDead(vdest, vdest->length + i, true);
+	}
+	vdest->deadCount += vsrc->deadCount;
+    }
+
     vdest->length += vsrc->length;
 }
 
@@ -219,6 +263,12 @@ void vector_move(vector* vdest, vector* vsrc) {
     vsrc->data = NULL;
     vsrc->status = vectorStatus_freed;
 
+    vdest->dead = vsrc->dead;
+    vdest->deadCount = vsrc->deadCount;
+    vdest->compactRead = vsrc->compactRead;
+    vdest->compactWrite = vsrc->compactWrite;
+    vsrc->dead = NULL;
+
     vdest->length = vsrc->length;
     vdest->capacity = vsrc->capacity;
     vdest->elementSize = vsrc->elementSize;
@@ -237,9 +287,17 @@ void vector_swap(vector* v1, vector* v2) {
     internal_gswap(&v1->capacity, &v2->capacity, sizeof(size_t));
     internal_gswap(&v1->elementSize, &v2->elementSize, sizeof(size_t));
 
+    internal_gswap(&v1->deadCount, &v2->deadCount, sizeof(size_t));
+    internal_gswap(&v1->compactRead, &v2->compactRead, sizeof(size_t));
+    internal_gswap(&v1->compactWrite, &v2->compactWrite, sizeof(size_t));
+
     void* temp = v1->data;
     v1->data = v2->data;
     v2->data = temp;
+
+    uint64_t* dead = v1->dead;
+    v1->dead = v2->dead;
+    v2->dead = dead;
     
     v1->status = v2->status = vectorStatus_success;
 }
@@ -307,9 +365,387 @@ bool vector_isEmpty(const vector* v) {
     return (v->length == 0);
 }
 
+void vector_markDead(vector* v, const size_t index) {
+    if(internal_vector_errorFound(v)) {
+	v->status = vectorStatus_error_operation;
+	return;
+    }
+
+    if(!internal_vector_checkIndexBounds(v, index)) {
+	return;
+    }
+
+    if(v->dead == NULL && !internal_vector_deadReserve(v, v->capacity)) {
+	v->status = vectorStatus_error_resize;
+	return;
+    }
+
+    if(!vector_isDead(v, index)) {
+	internal_vector_setDead(v, index, true);
+	v->deadCount++;
+    }
+}
+
+bool vector_isDead(const vector* v, const size_t index) {
+    if(v->dead == NULL || index >= v->length) {
+	return false;
+    }
+
+    return (v->dead[index / VECTOR_DEAD_WORD_BITS] >> (index % VECTOR_DEAD_WORD_BITS)) & 1;
+}
+
+size_t vector_nextAlive(const vector* v, const size_t index) {
+    if(index >= v->length) {
+	return v->length;
+    }
+
+    return internal_vector_findBit(v, index, v->length, false);
+}
+
+size_t vector_deadCount(const vector* v) {
+    return v->deadCount;
+}
+
+double vector_deadRatio(const vector* v) {
+    if(v->length == 0) {
+	return 0.0;
+    }
+
+    return ((double)v->deadCount / (double)v->length);
+}
+
+bool vector_compactStep(vector* v, const size_t budget) {
+    if(internal_vector_errorFound(v)) {
+	v->status = vectorStatus_error_operation;
+	return false;
+    }
+
+    // elements compactWrite..compactRead-1 form the gap: they are always marked dead, so the vector
+    // stays consistent between steps and can be read, pushed to or marked while a pass is in progress
+    size_t steps = 0;
+    while(v->deadCount > 0 && steps < budget) {
+	if(v->compactRead >= v->length) {
+	    // end of pass: everything after compactWrite is dead
+	    size_t length = v->compactWrite;
+	    internal_vector_deadTruncate(v, length);
+	    v->length = length;
+	    v->compactRead = v->compactWrite = 0;
+	    continue;
+	}
+
+	size_t remaining = budget - steps;
+	size_t limit = (v->length - v->compactRead <= remaining) ? (v->length) : (v->compactRead + remaining);
+	size_t next = 0;
+
+	if(v->compactRead == v->compactWrite) {
+	    // no gap yet: skip the live prefix a word at a time
+	    next = internal_vector_findBit(v, v->compactRead, limit, true);
+	    v->compactWrite = next;
+	    if(next < limit) {
+		next++;
+	    }
+	} else if(vector_isDead(v, v->compactRead)) {
+	    // widen the gap over a run of dead elements
+	    next = internal_vector_findBit(v, v->compactRead, limit, false);
+	} else {
+	    // slide a run of live elements down over the gap
+	    next = internal_vector_findBit(v, v->compactRead, limit, true);
+	    size_t count = next - v->compactRead;
+	    memmove(internal_vector_offset(v, v->compactWrite), internal_vector_offset(v, v->compactRead), count * v->elementSize);
+	    for(size_t i = 0; i < count; i++) {
+		internal_vector_setDead(v, v->compactWrite + i, false);
+		internal_vector_setDead(v, v->compactRead + i, true);
+	    }
+	    v->compactWrite += count;
+	}
+
+	steps += next - v->compactRead;
+	v->compactRead = next;
+    }
+
+    return (v->deadCount == 0);
+}
+
+void vector_batchCreate(vector_batch* b, vector* v) {
+    b->target = v;
+
+    vector_create(&b->items, (v != NULL) ? (v->elementSize) : (1));
+    vector_create(&b->inserts, sizeof(vector_batchEntry));
+    vector_create(&b->removes, sizeof(size_t));
+
+    if(v == NULL || internal_vector_errorFound(&b->items) || internal_vector_errorFound(&b->inserts) || internal_vector_errorFound(&b->removes)) {
+	vector_batchFree(b);
+	b->status = vectorStatus_error_init;
+	return;
+    }
+
+    b->status = vectorStatus_success;
+}
+
+void vector_batchPush(vector_batch* b, const void* item) {
+    internal_vector_batchRecord(b, VECTOR_BATCH_END, item);
+}
+
+void vector_batchInsert(vector_batch* b, const size_t index, const void* item) {
+    if(index == VECTOR_BATCH_END) {
+	b->status = vectorStatus_error_elementDoesntExist;
+	return;
+    }
+
+    internal_vector_batchRecord(b, index, item);
+}
+
+void vector_batchRemove(vector_batch* b, const size_t index) {
+    if(internal_vector_errorFound(&b->removes)) {
+	b->status = vectorStatus_error_operation;
+	return;
+    }
+
+    vector_push(&b->removes, &index);
+    if(vector_status_code(&b->removes) != vectorStatus_success) {
+	b->status = vectorStatus_error_resize;
+    }
+}
+
+void vector_batchCommit(vector_batch* b) {
+    vector* v = b->target;
+    if(internal_vector_errorFound(v)) {
+	if(v != NULL) {
+	    v->status = vectorStatus_error_operation;
+	}
+	return;
+    }
+
+    if(b->status != vectorStatus_success) {
+	v->status = vectorStatus_error_operation;
+	return;
+    }
+
+    vector_batchEntry* entries = b->inserts.data;
+    size_t* removes = b->removes.data;
+    size_t ni = b->inserts.length;
+    size_t nr = b->removes.length;
+
+    // validate before sorting, so a failed commit leaves the batch as it was recorded
+    bool positional = false;
+    for(size_t i = 0; i < ni; i++) {
+	if(entries[i].index == VECTOR_BATCH_END) {
+	    continue;
+	}
+
+	positional = true;
+	if(entries[i].index > v->length) {
+	    v->status = vectorStatus_error_elementDoesntExist;
+	    return;
+	}
+    }
+
+    for(size_t i = 0; i < nr; i++) {
+	if(removes[i] >= v->length) {
+	    v->status = vectorStatus_error_elementDoesntExist;
+	    return;
+	}
+    }
+
+    if((positional || nr > 0) && v->deadCount > 0) {
+	v->status = vectorStatus_error_operation;
+	return;
+    }
+
+    // inserts by original index (appends last), recording order kept among equal ones; removes sorted and deduplicated
+    qsort(entries, ni, sizeof(vector_batchEntry), internal_vector_batchCompareEntry);
+    qsort(removes, nr, sizeof(size_t), internal_vector_batchCompareIndex);
+    size_t unique = 0;
+    for(size_t i = 0; i < nr; i++) {
+	if(unique == 0 || removes[unique-1] != removes[i]) {
+	    removes[unique++] = removes[i];
+	}
+    }
+    b->removes.length = nr = unique;
+
+    size_t length = v->length - nr + ni;
+    size_t capacity = v->capacity;
+    if(length > capacity) {
+	capacity = (capacity * VECTOR_GROWTH_RATE > length) ? (capacity * VECTOR_GROWTH_RATE) : (length);
+    }
+
+    if(!positional && nr == 0) {
+	// appends only: grow once, copy at the end
+	if(capacity != v->capacity) {
+	    internal_vector_resize(v, capacity);
+	    if(v->capacity != capacity) {
+		return;
+	    }
+	}
+
+	for(size_t i = 0; i < ni; i++) {
+	    internal_vector_assign(v, v->length++, internal_vector_offset(&b->items, entries[i].item));
+	}
+    } else if(ni == 0) {
+	// removals only: close the gaps in one forward pass
+	size_t write = removes[0];
+	for(size_t r = 0; r < nr; r++) {
+	    size_t from = removes[r] + 1;
+	    size_t to = (r+1 < nr) ? (removes[r+1]) : (v->length);
+	    memmove(internal_vector_offset(v, write), internal_vector_offset(v, from), (to - from) * v->elementSize);
+	    write += to - from;
+	}
+
+	v->length = write;
+	v->compactRead = v->compactWrite = 0;
+    } else if(length <= v->capacity) {
+	// elements shift both ways in place: runs moving left are moved front to back,
+	// then runs moving right and the inserted items are placed back to front
+	size_t out = 0, src = 0, k = 0, r = 0;
+	for(;;) {
+	    size_t next = v->length;
+	    if(k < ni && entries[k].index < next) {
+		next = entries[k].index;
+	    }
+	    if(r < nr && removes[r] < next) {
+		next = removes[r];
+	    }
+
+	    if(out < src) {
+		memmove(internal_vector_offset(v, out), internal_vector_offset(v, src), (next - src) * v->elementSize);
+	    }
+	    out += next - src;
+	    src = next;
+
+	    while(k < ni && (entries[k].index == src || src == v->length)) {
+		k++;
+		out++;
+	    }
+
+	    if(src == v->length) {
+		break;
+	    }
+
+	    if(r < nr && removes[r] == src) {
+		r++;
+		src++;
+	    }
+	}
+
+	out = length;
+	src = v->length;
+	r = nr;
+	for(;;) {
+	    while(k > 0 && entries[k-1].index >= src) {
+		k--;
+		internal_vector_assign(v, --out, internal_vector_offset(&b->items, entries[k].item));
+	    }
+
+	    if(src == 0) {
+		break;
+	    }
+
+	    if(r > 0 && removes[r-1] == src-1) {
+		r--;
+		src--;
+		continue;
+	    }
+
+	    // run of kept elements back to the previous insertion or removal
+	    size_t prev = (k > 0) ? (entries[k-1].index) : (0);
+	    if(r > 0 && removes[r-1] + 1 > prev) {
+		prev = removes[r-1] + 1;
+	    }
+
+	    size_t dest = out - (src - prev);
+	    if(dest > prev) {
+		memmove(internal_vector_offset(v, dest), internal_vector_offset(v, prev), (src - prev) * v->elementSize);
+	    }
+	    out = dest;
+	    src = prev;
+	}
+
+	v->length = length;
+	v->compactRead = v->compactWrite = 0;
+    } else {
+	// elements shift both ways and the vector grows: build the result in a new buffer in one pass
+	if(v->dead != NULL && !internal_vector_deadReserve(v, capacity)) {
+	    v->status = vectorStatus_error_resize;
+	    return;
+	}
+
+	uint8_t* data = NULL;
+	data = malloc(capacity * v->elementSize);
+	if(data == NULL) {
+	    v->status = vectorStatus_error_resize;
+	    return;
+	}
+
+	size_t out = 0, src = 0, k = 0, r = 0;
+	for(;;) {
+	    // copy the run of kept elements up to the next insertion or removal
+	    size_t next = v->length;
+	    if(k < ni && entries[k].index < next) {
+		next = entries[k].index;
+	    }
+	    if(r < nr && removes[r] < next) {
+		next = removes[r];
+	    }
+
+	    memcpy(data + out * v->elementSize, internal_vector_offset(v, src), (next - src) * v->elementSize);
+	    out += next - src;
+	    src = next;
+
+	    // everything left is inserted once the end is reached
+	    while(k < ni && (entries[k].index == src || src == v->length)) {
+		memcpy(data + (out++) * v->elementSize, internal_vector_offset(&b->items, entries[k++].item), v->elementSize);
+	    }
+
+	    if(src == v->length) {
+		break;
+	    }
+
+	    if(r < nr && removes[r] == src) {
+		r++;
+		src++;
+	    }
+	}
+
+	free(v->data);
+	v->data = data;
+	v->capacity = capacity;
+	v->length = length;
+	v->compactRead = v->compactWrite = 0;
+    }
+
+    vector_batchClear(b);
+    v->status = vectorStatus_success;
+}
+
+size_t vector_batchLength(const vector_batch* b) {
+    return (b->inserts.length + b->removes.length);
+}
+
+void vector_batchClear(vector_batch* b) {
+    b->items.length = 0;
+    b->inserts.length = 0;
+    b->removes.length = 0;
+    b->items.status = b->inserts.status = b->removes.status = vectorStatus_success;
+    b->status = vectorStatus_success;
+}
+
+void vector_batchFree(vector_batch* b) {
+    vector_free(&b->items);
+    vector_free(&b->inserts);
+    vector_free(&b->removes);
+
+    b->target = NULL;
+    b->status = vectorStatus_freed;
+}
+
 /* ****** PRIVATE VECTOR METHODS FOR INTERNAL USE ONLY ****** */
 
 static void internal_vector_resize(vector* v, const size_t size) {
+    if(v->dead != NULL && !internal_vector_deadReserve(v, size)) {
+	v->status = vectorStatus_error_resize;
+	return;
+    }
+
     void* data = NULL;
     data = realloc(v->data, v->elementSize * size);
     if(data == NULL) {
@@ -320,6 +756,7 @@ static void internal_vector_resize(vector* v, const size_t size) {
     v->data = data;
     v->capacity = size;
     if(v->length > size) {
+	internal_vector_deadTruncate(v, size);
 	v->length = size;
     }
 }
@@ -356,6 +793,134 @@ static void internal_gswap(void* a, void* b, const size_t size) {
     memmove(b, temp, size);
 }
 
+static size_t internal_vector_deadWords(const size_t num) {
+    return (num + VECTOR_DEAD_WORD_BITS - 1) / VECTOR_DEAD_WORD_BITS;
+}
+
+static bool internal_vector_deadReserve(vector* v, const size_t capacity) {
+    if(v->dead == NULL) {
+	v->dead = calloc(internal_vector_deadWords(capacity), sizeof(uint64_t));
+	return (v->dead != NULL);
+    }
+
+    // the bitmap never shrinks, so it always covers at least v->capacity elements
+    size_t oldWords = internal_vector_deadWords(v->capacity);
+    size_t newWords = internal_vector_deadWords(capacity);
+    if(newWords <= oldWords) {
+	return true;
+    }
+
+    uint64_t* dead = NULL;
+    dead = realloc(v->dead, newWords * sizeof(uint64_t));
+    if(dead == NULL) {
+	return false;
+    }
+
+    memset(dead + oldWords, 0, (newWords - oldWords) * sizeof(uint64_t));
+    v->dead = dead;
+    return true;
+}
+
+static void internal_vector_deadTruncate(vector* v, const size_t length) {
+    if(v->compactRead > length) {
+	v->compactRead = v->compactWrite = 0;
+    }
+
+    if(v->deadCount == 0 || length >= v->length) {
+	return;
+    }
+
+    // clear bits length..v->length-1 a word at a time
+    for(size_t i = length; i < v->length; i = (i / VECTOR_DEAD_WORD_BITS + 1) * VECTOR_DEAD_WORD_BITS) {
+	uint64_t mask = ~0ULL << (i % VECTOR_DEAD_WORD_BITS);
+	size_t end = (i / VECTOR_DEAD_WORD_BITS + 1) * VECTOR_DEAD_WORD_BITS;
+	if(end > v->length) {
+	    mask &= ~0ULL >> (end - v->length);
+	}
+
+	uint64_t* word = &v->dead[i / VECTOR_DEAD_WORD_BITS];
+#if defined(__GNUC__)
+	v->deadCount -= __builtin_popcountll(*word & mask);
+#else
+	for(uint64_t bits = *word & mask; bits != 0; bits &= bits - 1) {
+	    v->deadCount--;
+	}
+#endif
+	*word &= ~mask;
+    }
+}
+
+static size_t internal_vector_findBit(const vector* v, const size_t from, const size_t to, const bool dead) {
+    if(v->dead == NULL) {
+	return (dead) ? (to) : (from);
+    }
+
+    for(size_t i = from; i < to; i = (i / VECTOR_DEAD_WORD_BITS + 1) * VECTOR_DEAD_WORD_BITS) {
+	uint64_t word = (dead) ? (v->dead[i / VECTOR_DEAD_WORD_BITS]) : (~v->dead[i / VECTOR_DEAD_WORD_BITS]);
+	word &= ~0ULL << (i % VECTOR_DEAD_WORD_BITS);
+	if(word == 0) {
+	    continue;
+	}
+
+#if defined(__GNUC__)
+	size_t bit = __builtin_ctzll(word);
+#else
+	size_t bit = 0;
+	while(((word >> bit) & 1) == 0) {
+	    bit++;
+	}
+#endif
+	size_t found = (i / VECTOR_DEAD_WORD_BITS) * VECTOR_DEAD_WORD_BITS + bit;
+	return (found < to) ? (found) : (to);
+    }
+
+    return to;
+}
+
+static void internal_vector_setDead(vector* v, const size_t index, const bool dead) {
+    uint64_t bit = 1ULL << (index % VECTOR_DEAD_WORD_BITS);
+    if(dead) {
+	v->dead[index / VECTOR_DEAD_WORD_BITS] |= bit;
+    } else {
+	v->dead[index / VECTOR_DEAD_WORD_BITS] &= ~bit;
+    }
+}
+
+static void internal_vector_batchRecord(vector_batch* b, const size_t index, const void* item) {
+    if(item == NULL || internal_vector_errorFound(&b->items) || internal_vector_errorFound(&b->inserts)) {
+	b->status = vectorStatus_error_null;
+	return;
+    }
+
+    vector_batchEntry entry = { index, b->items.length };
+    vector_push(&b->items, item);
+    if(vector_status_code(&b->items) != vectorStatus_success) {
+	b->status = vectorStatus_error_resize;
+	return;
+    }
+
+    vector_push(&b->inserts, &entry);
+    if(vector_status_code(&b->inserts) != vectorStatus_success) {
+	vector_pop(&b->items);
+	b->status = vectorStatus_error_resize;
+    }
+}
+
+static int internal_vector_batchCompareEntry(const void* a, const void* b) {
+    const vector_batchEntry* x = a;
+    const vector_batchEntry* y = b;
+    if(x->index != y->index) {
+	return (x->index < y->index) ? (-1) : (1);
+    }
+
+    return (x->item > y->item) - (x->item < y->item);
+}
+
+static int internal_vector_batchCompareIndex(const void* a, const void* b) {
+    size_t x = *(const size_t*)a, y = *(const size_t*)b;
+    return (x > y) - (x < y);
+}
+
 
 
 
@@ -31,6 +31,20 @@
  *  - vector_availableSpace
  *  - vector_memory
  *  - vector_isEmpty
+ *  - vector_markDead
+ *  - vector_isDead
+ *  - vector_nextAlive
+ *  - vector_deadCount
+ *  - vector_deadRatio
+ *  - vector_compactStep
+ *  - vector_batchCreate
+ *  - vector_batchPush
+ *  - vector_batchInsert
+ *  - vector_batchRemove
+ *  - vector_batchCommit
+ *  - vector_batchLength
+ *  - vector_batchClear
+ *  - vector_batchFree
  *
  * private vector functions:
  *  - internal_vector_resize
@@ -39,6 +53,14 @@
  *  - internal_vector_checkIndexBounds
  *  - internal_vector_errorFound
  *  - internal_gswap
+ *  - internal_vector_deadWords
+ *  - internal_vector_deadReserve
+ *  - internal_vector_deadTruncate
+ *  - internal_vector_findBit
+ *  - internal_vector_setDead
+ *  - internal_vector_batchRecord
+ *  - internal_vector_batchCompareEntry
+ *  - internal_vector_batchCompareIndex
 */
 
 #include <stdio.h>
@@ -47,8 +69,14 @@
 #include <stdbool.h>
 #include <string.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #define VECTOR_INIT_CAPACITY 4
 #define VECTOR_GROWTH_RATE 2
+#define VECTOR_DEAD_WORD_BITS 64
+#define VECTOR_BATCH_END SIZE_MAX
 
 /* ****** MACROS ****** */
 
@@ -82,6 +110,22 @@
 #define mvector_availableSpace(v) vector_availableSpace(&v)
 #define mvector_memory(v) vector_memory(&v)
 #define mvector_isEmpty(v) vector_isEmpty(&v)
+#define mvector_markDead(v, index) vector_markDead(&v, index)
+#define mvector_isDead(v, index) vector_isDead(&v, index)
+#define mvector_nextAlive(v, index) vector_nextAlive(&v, index)
+#define mvector_deadCount(v) vector_deadCount(&v)
+#define mvector_deadRatio(v) vector_deadRatio(&v)
+#define mvector_compactStep(v, budget) vector_compactStep(&v, budget)
+#define mvector_batchCreate(b, v) vector_batch b; vector_batchCreate(&b, &v)
+#define mvector_batchPush(b, item) vector_batchPush(&b, (void*)(&item))
+#define mvector_batchInsert(b, index, item) vector_batchInsert(&b, index, (void*)(&item))
+#define mvector_batchPushVal(b, val, type); { type x = val; vector_batchPush(&b, (void*)(&x)); }
+#define mvector_batchInsertVal(b, index, val, type); { type x = val; vector_batchInsert(&b, index, (void*)(&x)); }
+#define mvector_batchRemove(b, index) vector_batchRemove(&b, index)
+#define mvector_batchCommit(b) vector_batchCommit(&b)
+#define mvector_batchLength(b) vector_batchLength(&b)
+#define mvector_batchClear(b) vector_batchClear(&b)
+#define mvector_batchFree(b) vector_batchFree(&b)
 
 /* ****** VECTOR STRUCTURES ****** */
 
@@ -120,8 +164,28 @@ typedef struct vector {
     vectorStatus status;  // vector status
     
     void* data;           // vector data
+
+    uint64_t* dead;       // tombstone bitmap, one bit per element (NULL until the first vector_markDead)
+    size_t deadCount;     // number of elements marked dead
+    size_t compactRead;   // incremental compaction: next element to examine
+    size_t compactWrite;  // incremental compaction: next free slot for a live element
 } vector;
 
+// pending insertion of a batch
+typedef struct vector_batchEntry {
+    size_t index;  // original index to insert before, VECTOR_BATCH_END to append
+    size_t item;   // index of the element in vector_batch.items
+} vector_batchEntry;
+
+// batch of pending operations on a vector
+typedef struct vector_batch {
+    vector* target;       // vector the batch is applied to
+    vector items;         // elements to insert/append, in the order they were recorded
+    vector inserts;       // vector_batchEntry per insertion/append
+    vector removes;       // original indices to remove
+    vectorStatus status;  // status of the last recording (an error blocks vector_batchCommit until vector_batchClear)
+} vector_batch;
+
 /* ****** PUBLIC VECTOR METHODS ****** */
 
 /* initializes a vector 
@@ -309,6 +373,106 @@ size_t vector_memory(const vector* v);
 */
 bool vector_isEmpty(const vector* v);
 
+/* marks an element dead in O(1) without moving any data (order is preserved, the element stays in place until compaction)
+ *  params:
+ *	vector* v    => vector instance
+ *	size_t index => index
+*/
+void vector_markDead(vector* v, const size_t index);
+
+/* returns true if the element at an index is marked dead
+ *  params:
+ *	vector* v    => vector instance
+ *	size_t index => index
+*/
+bool vector_isDead(const vector* v, const size_t index);
+
+/* returns the index of the first live element at or after index, or vector length if there is none
+ *  usage: for(size_t i = vector_nextAlive(&v, 0); i < vector_length(&v); i = vector_nextAlive(&v, i+1)) { ... }
+ *  params:
+ *	vector* v    => vector instance
+ *	size_t index => index to start searching from
+*/
+size_t vector_nextAlive(const vector* v, const size_t index);
+
+/* returns the number of elements marked dead
+ *  params:
+ *	vector* v => vector instance
+*/
+size_t vector_deadCount(const vector* v);
+
+/* returns the dead element ratio (deadCount / length), 0 if vector is empty
+ *  params:
+ *	vector* v => vector instance
+*/
+double vector_deadRatio(const vector* v);
+
+/* compacts the vector incrementally: examines at most budget elements, sliding live elements over dead ones (order is preserved);
+ * once a pass reaches the end, the vector length is reduced by the number of reclaimed elements.
+ * Indices of live elements change as they are moved. Returns true if no dead elements are left.
+ *  params:
+ *	vector* v     => vector instance
+ *	size_t budget => maximum number of elements to examine in this step
+*/
+bool vector_compactStep(vector* v, const size_t budget);
+
+/* initializes a batch of operations on a vector: operations are recorded and applied together by vector_batchCommit.
+ * Indices always refer to the vector as it was before the commit.
+ *  params:
+ *	vector_batch* b => vector_batch instance
+ *	vector* v       => vector the batch is applied to
+*/
+void vector_batchCreate(vector_batch* b, vector* v);
+
+/* records an item to push at the end of vector (items are appended in the order they were recorded)
+ *  params:
+ *	vector_batch* b => vector_batch instance
+ *	void* item      => value
+*/
+void vector_batchPush(vector_batch* b, const void* item);
+
+/* records an item to insert before the element at index, shifting the following elements (unlike vector_insert, which overwrites);
+ * index = vector length inserts before the pushed items
+ *  params:
+ *	vector_batch* b => vector_batch instance
+ *	size_t index    => original index
+ *	void* item      => value
+*/
+void vector_batchInsert(vector_batch* b, const size_t index, const void* item);
+
+/* records the removal of the element at index, preserving the order of the remaining ones (unlike vector_remove)
+ *  params:
+ *	vector_batch* b => vector_batch instance
+ *	size_t index    => original index
+*/
+void vector_batchRemove(vector_batch* b, const size_t index);
+
+/* applies all recorded operations with at most one reallocation, moving each element at most once, then clears the batch.
+ * The outcome is reported by the vector status: on failure the vector and the batch are left untouched.
+ * Inserts and removals require a vector without dead elements (see vector_compactStep).
+ *  params:
+ *	vector_batch* b => vector_batch instance
+*/
+void vector_batchCommit(vector_batch* b);
+
+/* returns the number of recorded operations
+ *  params:
+ *	vector_batch* b => vector_batch instance
+*/
+size_t vector_batchLength(const vector_batch* b);
+
+/* discards all recorded operations (does not realloc)
+ *  params:
+ *	vector_batch* b => vector_batch instance
+*/
+void vector_batchClear(vector_batch* b);
+
+/* frees batch memory (the target vector is not affected)
+ *  params:
+ *	vector_batch* b => vector_batch instance
+*/
+void vector_batchFree(vector_batch* b);
+
 /* ****** PRIVATE VECTOR METHODS FOR INTERNAL USE ONLY ****** */
 
 /* resizes the vector
@@ -353,6 +517,62 @@ static bool internal_vector_errorFound(const vector* v);
 */
 static void internal_gswap(void* a, void* b, const size_t size);
 
+/* returns the number of bitmap words needed to cover num elements
+ *  params:
+ *	size_t num => number of elements
+*/
+static size_t internal_vector_deadWords(const size_t num);
+
+/* grows the tombstone bitmap (if any) to cover capacity elements, new bits are cleared; returns false on failure
+ *  params:
+ *	vector* v       => vector instance
+ *	size_t capacity => number of elements to cover
+*/
+static bool internal_vector_deadReserve(vector* v, const size_t capacity);
+
+/* clears tombstones at and after length, updates deadCount and aborts a compaction pass that reaches past length
+ *  params:
+ *	vector* v     => vector instance
+ *	size_t length => new vector length
+*/
+static void internal_vector_deadTruncate(vector* v, const size_t length);
+
+/* returns the index of the first element in from..to-1 whose tombstone bit equals dead, or to if there is none
+ *  params:
+ *	vector* v   => vector instance
+ *	size_t from => first index to check
+ *	size_t to   => end of the range
+ *	bool dead   => bit value to look for
+*/
+static size_t internal_vector_findBit(const vector* v, const size_t from, const size_t to, const bool dead);
+
+/* sets or clears the tombstone bit of an element (the bitmap must exist)
+ *  params:
+ *	vector* v    => vector instance
+ *	size_t index => index
+ *	bool dead    => new bit value
+*/
+static void internal_vector_setDead(vector* v, const size_t index, const bool dead);
+
+/* records an insertion or an append
+ *  params:
+ *	vector_batch* b => vector_batch instance
+ *	size_t index    => original index or VECTOR_BATCH_END
+ *	void* item      => value
+*/
+static void internal_vector_batchRecord(vector_batch* b, const size_t index, const void* item);
+
+/* qsort comparison of vector_batchEntry (by index, then by recording order) and of size_t indices
+ *  params:
+ *	void* a, void* b => elements to compare
+*/
+static int internal_vector_batchCompareEntry(const void* a, const void* b);
+static int internal_vector_batchCompareIndex(const void* a, const void* b);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // VECTOR_H
 
 
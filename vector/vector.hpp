@@ -0,0 +1,346 @@
+#ifndef VECTOR_HPP
+#define VECTOR_HPP
+
+/****** CVECTOR::VECTOR<T> ******
+ * Header-only C++ wrapper that owns a struct vector with elementSize fixed to sizeof(T).
+ * push/get are inlined and work on the C structure directly, so they compile down to the same
+ * code as std::vector. Trivially copyable T is moved with memcpy/realloc by the C core; any other T
+ * is relocated by the wrapper with proper constructor and destructor calls.
+ *
+ * cvector::vector<T> members:
+ *  - emplace_back, push_back, pop_back
+ *  - reserve, resize, clear, swap
+ *  - operator[], at, front, back, data
+ *  - size, capacity, empty
+ *  - begin, end (range-for)
+ *  - operator std::span<T> (C++20)
+ *  - c_vector (access to the underlying struct vector)
+ *
+ * Requires C++17; vector.c must be compiled as C and linked in.
+*/
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__has_include)
+#if __has_include(<span>) && __cplusplus >= 202002L
+#include <span>
+#endif
+#endif
+
+#include "vector.h"
+
+namespace cvector {
+
+template <typename T>
+class vector {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "cvector::vector: over-aligned types are not supported");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    /* ****** CONSTRUCTION ****** */
+
+    // empty vector, allocates nothing until the first insertion
+    vector() noexcept : v_(null_vector()) {}
+
+    // n value-initialized elements
+    explicit vector(const size_type n) : v_(null_vector()) {
+	try {
+	    resize(n);
+	} catch(...) {
+	    release();
+	    throw;
+	}
+    }
+
+    vector(std::initializer_list<T> items) : v_(null_vector()) {
+	try {
+	    reserve(items.size());
+	    std::uninitialized_copy(items.begin(), items.end(), data());
+	} catch(...) {
+	    release();
+	    throw;
+	}
+	v_.length = items.size();
+    }
+
+    // takes ownership of a C vector (vector_move frees the source)
+    explicit vector(::vector&& other) : v_(null_vector()) {
+	static_assert(std::is_trivially_copyable_v<T>, "cvector::vector: only trivially copyable types can adopt a C vector");
+	if(other.elementSize != sizeof(T)) {
+	    throw std::invalid_argument("cvector::vector: element size mismatch");
+	}
+
+	create();
+	vector_move(&v_, &other);
+    }
+
+    vector(const vector& other) : v_(null_vector()) {
+	try {
+	    reserve(other.size());
+	    if constexpr(std::is_trivially_copyable_v<T>) {
+		if(other.size() > 0) {
+		    std::memcpy(static_cast<void*>(data()), other.data(), other.size() * sizeof(T));
+		}
+	    } else {
+		std::uninitialized_copy(other.begin(), other.end(), data());
+	    }
+	} catch(...) {
+	    release();
+	    throw;
+	}
+	v_.length = other.size();
+    }
+
+    // steals the C vector, other is left empty
+    vector(vector&& other) noexcept : v_(null_vector()) {
+	vector_swap(&v_, &other.v_);
+    }
+
+    vector& operator=(const vector& other) {
+	if(this != &other) {
+	    vector copy(other);
+	    swap(copy);
+	}
+	return *this;
+    }
+
+    vector& operator=(vector&& other) noexcept {
+	if(this != &other) {
+	    vector moved(std::move(other));
+	    swap(moved);
+	}
+	return *this;
+    }
+
+    ~vector() {
+	destroy(begin(), end());
+	release();
+    }
+
+    /* ****** MODIFIERS ****** */
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+	if(v_.length == v_.capacity) {
+	    return emplace_back_grow(std::forward<Args>(args)...);
+	}
+
+	T* item = ::new(static_cast<void*>(data() + v_.length)) T(std::forward<Args>(args)...);
+	++v_.length;
+	return *item;
+    }
+
+    void push_back(const T& item) {
+	emplace_back(item);
+    }
+
+    void push_back(T&& item) {
+	emplace_back(std::move(item));
+    }
+
+    void pop_back() {
+	--v_.length;
+	data()[v_.length].~T();
+    }
+
+    // makes room for at least n elements
+    void reserve(const size_type n) {
+	if(n > v_.capacity || v_.data == NULL) {
+	    relocate(n);
+	}
+    }
+
+    // grows with value-initialized elements or destroys the tail
+    void resize(const size_type n) {
+	if(n < size()) {
+	    destroy(begin() + n, end());
+	} else {
+	    reserve(n);
+	    std::uninitialized_value_construct(end(), data() + n);
+	}
+	v_.length = n;
+    }
+
+    // destroys all elements, keeps the capacity (unlike vector_clear)
+    void clear() noexcept {
+	destroy(begin(), end());
+	v_.length = 0;
+    }
+
+    void swap(vector& other) noexcept {
+	vector_swap(&v_, &other.v_);
+    }
+
+    /* ****** ACCESS ****** */
+
+    T& operator[](const size_type index) { return data()[index]; }
+    const T& operator[](const size_type index) const { return data()[index]; }
+
+    T& at(const size_type index) {
+	check(index);
+	return data()[index];
+    }
+
+    const T& at(const size_type index) const {
+	check(index);
+	return data()[index];
+    }
+
+    T& front() { return data()[0]; }
+    const T& front() const { return data()[0]; }
+    T& back() { return data()[v_.length - 1]; }
+    const T& back() const { return data()[v_.length - 1]; }
+
+    T* data() noexcept { return static_cast<T*>(v_.data); }
+    const T* data() const noexcept { return static_cast<const T*>(v_.data); }
+
+    size_type size() const noexcept { return v_.length; }
+    size_type capacity() const noexcept { return v_.capacity; }
+    bool empty() const noexcept { return v_.length == 0; }
+
+    iterator begin() noexcept { return data(); }
+    iterator end() noexcept { return data() + v_.length; }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + v_.length; }
+    const_iterator cbegin() const noexcept { return data(); }
+    const_iterator cend() const noexcept { return data() + v_.length; }
+
+#if defined(__cpp_lib_span)
+    operator std::span<T>() noexcept { return std::span<T>(data(), size()); }
+    operator std::span<const T>() const noexcept { return std::span<const T>(data(), size()); }
+#endif
+
+    // underlying C vector (for the C API: vector_getHead, vector_set*, etc...)
+    const ::vector* c_vector() const noexcept { return &v_; }
+
+private:
+    ::vector v_;
+
+    // C vector without storage, same state vector_free leaves behind
+    static ::vector null_vector() noexcept {
+	::vector v;
+	std::memset(static_cast<void*>(&v), 0, sizeof(v));
+	v.elementSize = sizeof(T);
+	v.status = vectorStatus_freed;
+	return v;
+    }
+
+    // frees the C buffer, the elements must already be destroyed (the destructor does not run when a constructor throws)
+    void release() noexcept {
+	if(v_.data != NULL) {
+	    vector_free(&v_);
+	}
+    }
+
+    void create() {
+	vector_create(&v_, sizeof(T));
+	if(v_.status != vectorStatus_success) {
+	    throw std::bad_alloc();
+	}
+    }
+
+    // moves the elements to a buffer of at least n elements
+    void relocate(const size_type n) {
+	if constexpr(std::is_trivially_copyable_v<T>) {
+	    // realloc is a valid move for these
+	    if(v_.data == NULL) {
+		create();
+	    }
+	    if(n > v_.capacity) {
+		vector_reserve(&v_, n - v_.capacity);
+	    }
+	    if(n > v_.capacity) {
+		throw std::bad_alloc();
+	    }
+	    return;
+	}
+
+	::vector fresh;
+	vector_create(&fresh, sizeof(T));
+	if(fresh.status == vectorStatus_success && n > fresh.capacity) {
+	    vector_reserve(&fresh, n - fresh.capacity);
+	}
+	if(fresh.status != vectorStatus_success || n > fresh.capacity) {
+	    if(fresh.data != NULL) {
+		vector_free(&fresh);
+	    }
+	    throw std::bad_alloc();
+	}
+
+	T* target = static_cast<T*>(fresh.data);
+	size_type moved = 0;
+	try {
+	    for(; moved < size(); ++moved) {
+		::new(static_cast<void*>(target + moved)) T(std::move_if_noexcept(data()[moved]));
+	    }
+	} catch(...) {
+	    destroy(target, target + moved);
+	    vector_free(&fresh);
+	    throw;
+	}
+
+	destroy(begin(), end());
+	fresh.length = v_.length;
+	vector_swap(&v_, &fresh);
+	if(fresh.data != NULL) {
+	    vector_free(&fresh);
+	}
+    }
+
+    // slow path of emplace_back: args may refer to an element, so the item is built before relocating
+    template <typename... Args>
+    T& emplace_back_grow(Args&&... args) {
+	T item(std::forward<Args>(args)...);
+	size_type grown = v_.capacity * VECTOR_GROWTH_RATE;
+	relocate((grown < VECTOR_INIT_CAPACITY) ? (VECTOR_INIT_CAPACITY) : (grown));
+
+	T* placed = ::new(static_cast<void*>(data() + v_.length)) T(std::move(item));
+	++v_.length;
+	return *placed;
+    }
+
+    static void destroy(T* first, T* last) noexcept {
+	if constexpr(!std::is_trivially_destructible_v<T>) {
+	    std::destroy(first, last);
+	}
+    }
+
+    void check(const size_type index) const {
+	if(index >= v_.length) {
+	    throw std::out_of_range("cvector::vector: index out of range");
+	}
+    }
+};
+
+template <typename T>
+void swap(vector<T>& a, vector<T>& b) noexcept {
+    a.swap(b);
+}
+
+} // namespace cvector
+
+#endif // VECTOR_HPP
+
+
+
+
+
+
+
+
+
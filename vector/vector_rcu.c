@@ -0,0 +1,293 @@
+// syscall() is not declared in strict C11 mode
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <sched.h>
+
+#if defined(__linux__)
+#include <linux/membarrier.h>
+#include <linux/version.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+// the membarrier commands are enum constants: MEMBARRIER_CMD_PRIVATE_EXPEDITED came with the 4.14 headers, the syscall with 4.3
+#if defined(__NR_membarrier) && LINUX_VERSION_CODE >= KERNEL_VERSION(4, 14, 0)
+#define VECTOR_RCU_MEMBARRIER
+#endif
+#endif
+
+#include "vector_rcu.h"
+
+/* Documentation: READ vector_rcu.h */
+
+/* ****** PUBLIC VECTOR RCU METHODS ****** */
+
+void vector_rcuCreate(vector_rcu* r, const size_t elementSize) {
+    r->elementSize = elementSize;
+    r->pending = NULL;
+    r->readerFence = true;
+    atomic_init(&r->epoch, 1);
+    atomic_init(&r->current, NULL);
+
+    for(size_t i = 0; i < VECTOR_RCU_MAX_READERS; i++) {
+	atomic_init(&r->readers[i].epoch, 0);
+	atomic_init(&r->readers[i].used, false);
+    }
+
+    vector_create(&r->retired, sizeof(vector_rcuRetiredVersion));
+    if(vector_status_code(&r->retired) != vectorStatus_success) {
+	r->status = vectorStatus_error_init;
+	return;
+    }
+
+    vector* version = internal_vector_rcuNewVersion(r, NULL);
+    if(version == NULL || pthread_mutex_init(&r->writeLock, NULL) != 0) {
+	internal_vector_rcuFreeVersion(version);
+	vector_free(&r->retired);
+	r->status = vectorStatus_error_init;
+	return;
+    }
+
+#if defined(VECTOR_RCU_MEMBARRIER)
+    // once registered, writers can fence all reader threads at once
+    if(syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0) {
+	r->readerFence = false;
+    }
+#endif
+
+    atomic_store(&r->current, version);
+    r->status = vectorStatus_success;
+}
+
+void vector_rcuFree(vector_rcu* r) {
+    if(r->status == vectorStatus_freed || r->status == vectorStatus_error_init) {
+	return;
+    }
+
+    for(size_t i = 0; i < vector_length(&r->retired); i++) {
+	vector_rcuRetiredVersion* retired = vector_get(&r->retired, i);
+	internal_vector_rcuFreeVersion(retired->version);
+    }
+
+    internal_vector_rcuFreeVersion(r->pending);
+    internal_vector_rcuFreeVersion(atomic_exchange(&r->current, NULL));
+    r->pending = NULL;
+
+    vector_free(&r->retired);
+    pthread_mutex_destroy(&r->writeLock);
+    r->status = vectorStatus_freed;
+}
+
+size_t vector_rcuRegister(vector_rcu* r) {
+    for(size_t i = 0; i < VECTOR_RCU_MAX_READERS; i++) {
+	bool used = false;
+	if(atomic_compare_exchange_strong(&r->readers[i].used, &used, true)) {
+	    atomic_store(&r->readers[i].epoch, 0);
+	    return i;
+	}
+    }
+
+    return VECTOR_RCU_INVALID_READER;
+}
+
+void vector_rcuUnregister(vector_rcu* r, const size_t reader) {
+    if(reader >= VECTOR_RCU_MAX_READERS) {
+	return;
+    }
+
+    atomic_store(&r->readers[reader].epoch, 0);
+    atomic_store(&r->readers[reader].used, false);
+}
+
+const vector* vector_rcuReadLock(vector_rcu* r, const size_t reader) {
+    if(reader >= VECTOR_RCU_MAX_READERS) {
+	return NULL;
+    }
+
+    // announce the epoch before loading the version: a writer that misses the announcement
+    // has already published a newer version, so the old one is never handed out.
+    // The acquire pairs with the epoch increment in vector_rcuWriteCommit: seeing epoch N+1 means seeing its version
+    size_t epoch = atomic_load_explicit(&r->epoch, memory_order_acquire);
+    atomic_store_explicit(&r->readers[reader].epoch, epoch, memory_order_relaxed);
+
+    // the store must not move past the load below: membarrier in the writer orders it, the compiler must not reorder it
+    if(r->readerFence) {
+	atomic_thread_fence(memory_order_seq_cst);
+    } else {
+	atomic_signal_fence(memory_order_seq_cst);
+    }
+
+    return atomic_load_explicit(&r->current, memory_order_acquire);
+}
+
+void vector_rcuReadUnlock(vector_rcu* r, const size_t reader) {
+    if(reader >= VECTOR_RCU_MAX_READERS) {
+	return;
+    }
+
+    atomic_store_explicit(&r->readers[reader].epoch, 0, memory_order_release);
+}
+
+vector* vector_rcuWriteBegin(vector_rcu* r) {
+    if(pthread_mutex_lock(&r->writeLock) != 0) {
+	return NULL;
+    }
+
+    r->pending = internal_vector_rcuNewVersion(r, atomic_load_explicit(&r->current, memory_order_relaxed));
+    if(r->pending == NULL) {
+	r->status = vectorStatus_error_operation;
+	pthread_mutex_unlock(&r->writeLock);
+	return NULL;
+    }
+
+    r->status = vectorStatus_success;
+    return r->pending;
+}
+
+void vector_rcuWriteCommit(vector_rcu* r) {
+    if(r->pending == NULL) {
+	r->status = vectorStatus_error_null;
+	return;
+    }
+
+    vector* old = atomic_exchange_explicit(&r->current, r->pending, memory_order_seq_cst);
+    vector_rcuRetiredVersion retired = { old, atomic_fetch_add_explicit(&r->epoch, 1, memory_order_seq_cst) + 1 };
+    r->pending = NULL;
+
+    // every reader epoch scanned from now on was announced either before this point or with the new version
+    internal_vector_rcuBarrier(r);
+
+    if(vector_availableSpace(&r->retired) == 0) {
+	vector_reserve(&r->retired, vector_capacity(&r->retired));
+    }
+
+    if(vector_status_code(&r->retired) == vectorStatus_success) {
+	vector_push(&r->retired, &retired);
+    } else {
+	// nowhere to park the old version: wait for its readers and free it right away
+	while(internal_vector_rcuMinEpoch(r) < retired.epoch) {
+	    sched_yield();
+	}
+	internal_vector_rcuFreeVersion(old);
+	r->retired.status = vectorStatus_success;
+    }
+
+    pthread_mutex_unlock(&r->writeLock);
+    vector_rcuReclaim(r);
+}
+
+void vector_rcuWriteAbort(vector_rcu* r) {
+    if(r->pending == NULL) {
+	r->status = vectorStatus_error_null;
+	return;
+    }
+
+    internal_vector_rcuFreeVersion(r->pending);
+    r->pending = NULL;
+    pthread_mutex_unlock(&r->writeLock);
+}
+
+size_t vector_rcuReclaim(vector_rcu* r) {
+    pthread_mutex_lock(&r->writeLock);
+
+    size_t minEpoch = internal_vector_rcuMinEpoch(r);
+    for(size_t i = 0; i < vector_length(&r->retired); ) {
+	vector_rcuRetiredVersion* retired = vector_get(&r->retired, i);
+	if(retired->epoch > minEpoch) {
+	    i++;
+	    continue;
+	}
+
+	internal_vector_rcuFreeVersion(retired->version);
+	vector_remove(&r->retired, i);
+    }
+
+    size_t left = vector_length(&r->retired);
+    pthread_mutex_unlock(&r->writeLock);
+
+    return left;
+}
+
+void vector_rcuSynchronize(vector_rcu* r) {
+    // wait for the readers without the lock, then reclaim once
+    do {
+	size_t epoch = atomic_load(&r->epoch);
+	while(internal_vector_rcuMinEpoch(r) < epoch) {
+	    sched_yield();
+	}
+    } while(vector_rcuReclaim(r) > 0);
+}
+
+size_t vector_rcuRetired(vector_rcu* r) {
+    pthread_mutex_lock(&r->writeLock);
+    size_t retired = vector_length(&r->retired);
+    pthread_mutex_unlock(&r->writeLock);
+
+    return retired;
+}
+
+vectorStatus vector_rcuStatus(const vector_rcu* r) {
+    return r->status;
+}
+
+/* ****** PRIVATE VECTOR RCU METHODS FOR INTERNAL USE ONLY ****** */
+
+static vector* internal_vector_rcuNewVersion(vector_rcu* r, const vector* src) {
+    vector* version = NULL;
+    version = malloc(sizeof(vector));
+    if(version == NULL) {
+	return NULL;
+    }
+
+    vector_create(version, r->elementSize);
+    if(src != NULL && vector_length(src) > 0) {
+	vector_copy(version, src);
+    }
+
+    if(vector_status_code(version) != vectorStatus_success) {
+	internal_vector_rcuFreeVersion(version);
+	return NULL;
+    }
+
+    return version;
+}
+
+static void internal_vector_rcuFreeVersion(vector* version) {
+    if(version == NULL) {
+	return;
+    }
+
+    vector_free(version);
+    free(version);
+}
+
+static size_t internal_vector_rcuMinEpoch(vector_rcu* r) {
+    size_t minEpoch = atomic_load(&r->epoch);
+    for(size_t i = 0; i < VECTOR_RCU_MAX_READERS; i++) {
+	size_t epoch = atomic_load(&r->readers[i].epoch);
+	if(epoch != 0 && epoch < minEpoch) {
+	    minEpoch = epoch;
+	}
+    }
+
+    return minEpoch;
+}
+
+static void internal_vector_rcuBarrier(vector_rcu* r) {
+#if defined(VECTOR_RCU_MEMBARRIER)
+    if(!r->readerFence) {
+	syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+	return;
+    }
+#endif
+
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+
+
+
+
+
+
+
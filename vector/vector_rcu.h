@@ -0,0 +1,215 @@
+#ifndef VECTOR_RCU_H
+#define VECTOR_RCU_H
+
+/****** VECTOR RCU ******
+ * A read-mostly vector shared between threads. Readers get a consistent snapshot without locks;
+ * writers copy the current version, modify the copy and publish it with a pointer swap. Old versions
+ * are freed once every reader has left the epoch in which it could have seen them (epoch-based reclamation).
+ *
+ * A reader announces its epoch with a plain store. On Linux the writer makes those stores visible
+ * with membarrier(2), so the read path carries no fence and no atomic read-modify-write. Where membarrier
+ * is unavailable readers fall back to a full fence after the store, which x86 compilers emit as a locked instruction.
+ *
+ * public vector_rcu functions + macros(e.g. (m)vector_rcuCreate, etc...):
+ *  - vector_rcuCreate
+ *  - vector_rcuFree
+ *  - vector_rcuRegister
+ *  - vector_rcuUnregister
+ *  - vector_rcuReadLock
+ *  - vector_rcuReadUnlock
+ *  - vector_rcuWriteBegin
+ *  - vector_rcuWriteCommit
+ *  - vector_rcuWriteAbort
+ *  - vector_rcuReclaim
+ *  - vector_rcuSynchronize
+ *  - vector_rcuRetired
+ *  - vector_rcuStatus
+ *
+ * private vector_rcu functions:
+ *  - internal_vector_rcuNewVersion
+ *  - internal_vector_rcuFreeVersion
+ *  - internal_vector_rcuMinEpoch
+ *  - internal_vector_rcuBarrier
+ *
+ * requires C11 atomics and pthreads (link with -pthread)
+*/
+
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "vector.h"
+
+#define VECTOR_RCU_MAX_READERS 256
+#define VECTOR_RCU_CACHE_LINE 64
+#define VECTOR_RCU_INVALID_READER VECTOR_RCU_MAX_READERS
+
+/* ****** MACROS ****** */
+
+#define mvector_rcuCreate(r, type) vector_rcu r; vector_rcuCreate(&r, sizeof(type))
+#define mvector_rcuFree(r) vector_rcuFree(&r)
+#define mvector_rcuRegister(r) vector_rcuRegister(&r)
+#define mvector_rcuUnregister(r, reader) vector_rcuUnregister(&r, reader)
+#define mvector_rcuReadLock(r, reader) vector_rcuReadLock(&r, reader)
+#define mvector_rcuReadUnlock(r, reader) vector_rcuReadUnlock(&r, reader)
+#define mvector_rcuWriteBegin(r) vector_rcuWriteBegin(&r)
+#define mvector_rcuWriteCommit(r) vector_rcuWriteCommit(&r)
+#define mvector_rcuWriteAbort(r) vector_rcuWriteAbort(&r)
+#define mvector_rcuReclaim(r) vector_rcuReclaim(&r)
+#define mvector_rcuSynchronize(r) vector_rcuSynchronize(&r)
+#define mvector_rcuRetired(r) vector_rcuRetired(&r)
+#define mvector_rcuStatus(r) vector_rcuStatus(&r)
+
+/* ****** VECTOR RCU STRUCTURES ****** */
+
+// reader slot, one per registered reader thread (padded to a cache line, so readers never share one)
+typedef struct vector_rcuReader {
+    _Alignas(VECTOR_RCU_CACHE_LINE) atomic_size_t epoch;  // epoch the reader entered, 0 if outside a read section
+    atomic_bool used;                                      // slot is taken by a registered reader
+} vector_rcuReader;
+
+// version waiting to be freed
+typedef struct vector_rcuRetiredVersion {
+    vector* version;  // old version
+    size_t epoch;     // global epoch right after the version was replaced
+} vector_rcuRetiredVersion;
+
+// read-mostly vector data structure
+typedef struct vector_rcu {
+    // read by every reader: nothing on this cache line is written outside of a commit
+    _Alignas(VECTOR_RCU_CACHE_LINE) _Atomic(vector*) current;  // published version
+    atomic_size_t epoch;                                      // global epoch (starts at 1)
+    bool readerFence;                                         // readers issue a full fence (no membarrier)
+
+    // writer side, on its own cache line
+    _Alignas(VECTOR_RCU_CACHE_LINE) pthread_mutex_t writeLock;  // serializes writers
+    vector* pending;            // version being written (between vector_rcuWriteBegin and commit/abort)
+    vector retired;             // vector_rcuRetiredVersion entries not yet freed
+    size_t elementSize;         // element size
+    vectorStatus status;        // status of the last create/free/write operation (readers never touch it)
+
+    vector_rcuReader readers[VECTOR_RCU_MAX_READERS];
+} vector_rcu;
+
+/* ****** PUBLIC VECTOR RCU METHODS ****** */
+
+/* initializes a vector_rcu with an empty published version
+ *  params:
+ *	vector_rcu* r      => vector_rcu instance
+ *	size_t elementSize => sizeof(type)
+*/
+void vector_rcuCreate(vector_rcu* r, const size_t elementSize);
+
+/* frees all versions (no reader or writer may be active)
+ *  params:
+ *	vector_rcu* r => vector_rcu instance
+*/
+void vector_rcuFree(vector_rcu* r);
+
+/* registers the calling reader thread, returns its reader id or VECTOR_RCU_INVALID_READER if all slots are taken
+ *  params:
+ *	vector_rcu* r => vector_rcu instance
+*/
+size_t vector_rcuRegister(vector_rcu* r);
+
+/* releases a reader id (the reader must be outside a read section)
+ *  params:
+ *	vector_rcu* r  => vector_rcu instance
+ *	size_t reader  => reader id
+*/
+void vector_rcuUnregister(vector_rcu* r, const size_t reader);
+
+/* enters a read section and returns the current version; the snapshot stays valid until vector_rcuReadUnlock.
+ * Read sections do not nest. Use only functions taking a const vector* on the snapshot (vector_getHead, vector_length, etc...)
+ *  params:
+ *	vector_rcu* r => vector_rcu instance
+ *	size_t reader => reader id
+*/
+const vector* vector_rcuReadLock(vector_rcu* r, const size_t reader);
+
+/* leaves a read section
+ *  params:
+ *	vector_rcu* r => vector_rcu instance
+ *	size_t reader => reader id
+*/
+void vector_rcuReadUnlock(vector_rcu* r, const size_t reader);
+
+/* locks out other writers and returns a private copy of the current version to modify with the usual vector functions,
+ * returns NULL on failure
+ *  params:
+ *	vector_rcu* r => vector_rcu instance
+*/
+vector* vector_rcuWriteBegin(vector_rcu* r);
+
+/* publishes the copy returned by vector_rcuWriteBegin, retires the old version and frees whatever can be freed
+ *  params:
+ *	vector_rcu* r => vector_rcu instance
+*/
+void vector_rcuWriteCommit(vector_rcu* r);
+
+/* discards the copy returned by vector_rcuWriteBegin
+ *  params:
+ *	vector_rcu* r => vector_rcu instance
+*/
+void vector_rcuWriteAbort(vector_rcu* r);
+
+/* frees retired versions no reader can still see, returns the number of retired versions left
+ *  params:
+ *	vector_rcu* r => vector_rcu instance
+*/
+size_t vector_rcuReclaim(vector_rcu* r);
+
+/* waits until every retired version is freed (must not be called from inside a read section)
+ *  params:
+ *	vector_rcu* r => vector_rcu instance
+*/
+void vector_rcuSynchronize(vector_rcu* r);
+
+/* returns the number of retired versions waiting to be freed
+ *  params:
+ *	vector_rcu* r => vector_rcu instance
+*/
+size_t vector_rcuRetired(vector_rcu* r);
+
+/* returns the status of the last create/free/write operation
+ *  params:
+ *	vector_rcu* r => vector_rcu instance
+*/
+vectorStatus vector_rcuStatus(const vector_rcu* r);
+
+/* ****** PRIVATE VECTOR RCU METHODS FOR INTERNAL USE ONLY ****** */
+
+/* allocates a new version holding a copy of src (empty if src is NULL), returns NULL on failure
+ *  params:
+ *	vector_rcu* r => vector_rcu instance
+ *	vector* src   => version to copy
+*/
+static vector* internal_vector_rcuNewVersion(vector_rcu* r, const vector* src);
+
+/* frees a version
+ *  params:
+ *	vector* version => version to free
+*/
+static void internal_vector_rcuFreeVersion(vector* version);
+
+/* returns the smallest epoch of all readers inside a read section, or the global epoch if there is none
+ *  params:
+ *	vector_rcu* r => vector_rcu instance
+*/
+static size_t internal_vector_rcuMinEpoch(vector_rcu* r);
+
+/* makes every reader's epoch store issued so far visible to the writer (membarrier, or a plain fence if readers fence themselves)
+ *  params:
+ *	vector_rcu* r => vector_rcu instance
+*/
+static void internal_vector_rcuBarrier(vector_rcu* r);
+
+#endif // VECTOR_RCU_H
+
+
+
+
+
+
+
+
+
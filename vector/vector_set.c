@@ -0,0 +1,463 @@
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "vector_set.h"
+
+/* Documentation: READ vector_set.h */
+
+/* ****** PUBLIC VECTOR SET METHODS ****** */
+
+void vector_merge(vector* vdest, const vector* va, const vector* vb, vector_setCompare compare) {
+    compare = internal_vector_setPrepare(vdest, va, vb, compare);
+    if(compare == NULL || !internal_vector_setReserve(vdest, vector_length(va) + vector_length(vb))) {
+	return;
+    }
+
+    size_t na = vector_length(va), nb = vector_length(vb);
+    size_t i = 0, j = 0;
+    if(internal_vector_setIsUneven(va, vb) && na < nb) {
+	// copy runs of vb in bulk, elements of va go before equal ones
+	for(; i < na; i++) {
+	    size_t k = internal_vector_setGallop(vb, j, internal_vector_setAt(va, i), false, compare);
+	    internal_vector_setEmit(vdest, vb, j, k - j);
+	    internal_vector_setEmit(vdest, va, i, 1);
+	    j = k;
+	}
+    } else if(internal_vector_setIsUneven(va, vb)) {
+	// copy runs of va in bulk, elements of vb go after equal ones
+	for(; j < nb; j++) {
+	    size_t k = internal_vector_setGallop(va, i, internal_vector_setAt(vb, j), true, compare);
+	    internal_vector_setEmit(vdest, va, i, k - i);
+	    internal_vector_setEmit(vdest, vb, j, 1);
+	    i = k;
+	}
+    } else {
+	while(i < na && j < nb) {
+	    if(compare(internal_vector_setAt(vb, j), internal_vector_setAt(va, i)) < 0) {
+		internal_vector_setEmit(vdest, vb, j++, 1);
+	    } else {
+		internal_vector_setEmit(vdest, va, i++, 1);
+	    }
+	}
+    }
+
+    internal_vector_setEmit(vdest, va, i, na - i);
+    internal_vector_setEmit(vdest, vb, j, nb - j);
+}
+
+void vector_unique(vector* v, vector_setCompare compare) {
+    if(v == NULL) {
+	return;
+    }
+
+    if(vector_getHead(v) == NULL) {
+	v->status = vectorStatus_error_operation;
+	return;
+    }
+
+    if(vector_deadCount(v) > 0) {
+	v->status = vectorStatus_error_operation;
+	return;
+    }
+
+    compare = internal_vector_setResolve(v, compare);
+    if(compare == NULL) {
+	return;
+    }
+
+    size_t length = 0;
+    for(size_t i = 0; i < vector_length(v); i++) {
+	if(length > 0 && compare(internal_vector_setAt(v, length-1), internal_vector_setAt(v, i)) == 0) {
+	    continue;
+	}
+
+	if(length != i) {
+	    memcpy((void*)internal_vector_setAt(v, length), internal_vector_setAt(v, i), v->elementSize);
+	}
+	length++;
+    }
+
+    internal_vector_setTruncate(v, length);
+}
+
+void vector_setUnion(vector* vdest, const vector* va, const vector* vb, vector_setCompare compare) {
+    compare = internal_vector_setPrepare(vdest, va, vb, compare);
+    if(compare == NULL || !internal_vector_setReserve(vdest, vector_length(va) + vector_length(vb))) {
+	return;
+    }
+
+    if(internal_vector_setIsUneven(va, vb)) {
+	// walk the shorter set, copying runs of the longer one in bulk
+	const vector* vs = (vector_length(va) < vector_length(vb)) ? (va) : (vb);
+	const vector* vl = (vs == va) ? (vb) : (va);
+	size_t pos = 0;
+	for(size_t i = 0; i < vector_length(vs); i++) {
+	    const void* key = internal_vector_setAt(vs, i);
+	    size_t k = internal_vector_setGallop(vl, pos, key, false, compare);
+	    internal_vector_setEmit(vdest, vl, pos, k - pos);
+	    internal_vector_setEmit(vdest, vs, i, 1);
+	    pos = (k < vector_length(vl) && compare(internal_vector_setAt(vl, k), key) == 0) ? (k+1) : (k);
+	}
+
+	internal_vector_setEmit(vdest, vl, pos, vector_length(vl) - pos);
+	return;
+    }
+
+    size_t na = vector_length(va), nb = vector_length(vb);
+    size_t i = 0, j = 0;
+    while(i < na && j < nb) {
+	int order = compare(internal_vector_setAt(va, i), internal_vector_setAt(vb, j));
+	if(order < 0) {
+	    internal_vector_setEmit(vdest, va, i++, 1);
+	} else if(order > 0) {
+	    internal_vector_setEmit(vdest, vb, j++, 1);
+	} else {
+	    internal_vector_setEmit(vdest, va, i++, 1);
+	    j++;
+	}
+    }
+
+    internal_vector_setEmit(vdest, va, i, na - i);
+    internal_vector_setEmit(vdest, vb, j, nb - j);
+}
+
+void vector_setIntersect(vector* vdest, const vector* va, const vector* vb, vector_setCompare compare) {
+    bool integer = (compare == NULL);
+    compare = internal_vector_setPrepare(vdest, va, vb, compare);
+    if(compare == NULL) {
+	return;
+    }
+
+    size_t bound = (vector_length(va) < vector_length(vb)) ? (vector_length(va)) : (vector_length(vb));
+    if(!internal_vector_setReserve(vdest, bound)) {
+	return;
+    }
+
+    if(internal_vector_setIsUneven(va, vb)) {
+	const vector* vs = (vector_length(va) < vector_length(vb)) ? (va) : (vb);
+	const vector* vl = (vs == va) ? (vb) : (va);
+	size_t pos = 0;
+	for(size_t i = 0; i < vector_length(vs) && pos < vector_length(vl); i++) {
+	    const void* key = internal_vector_setAt(vs, i);
+	    pos = internal_vector_setGallop(vl, pos, key, false, compare);
+	    if(pos < vector_length(vl) && compare(internal_vector_setAt(vl, pos), key) == 0) {
+		internal_vector_setEmit(vdest, vs, i, 1);
+		pos++;
+	    }
+	}
+	return;
+    }
+
+    if(integer && va->elementSize == sizeof(uint32_t)) {
+	internal_vector_setIntersectU32(vdest, va, vb);
+	return;
+    }
+
+    if(integer && va->elementSize == sizeof(uint64_t)) {
+	internal_vector_setIntersectU64(vdest, va, vb);
+	return;
+    }
+
+    size_t na = vector_length(va), nb = vector_length(vb);
+    size_t i = 0, j = 0;
+    while(i < na && j < nb) {
+	int order = compare(internal_vector_setAt(va, i), internal_vector_setAt(vb, j));
+	if(order < 0) {
+	    i++;
+	} else if(order > 0) {
+	    j++;
+	} else {
+	    internal_vector_setEmit(vdest, va, i++, 1);
+	    j++;
+	}
+    }
+}
+
+void vector_setDifference(vector* vdest, const vector* va, const vector* vb, vector_setCompare compare) {
+    compare = internal_vector_setPrepare(vdest, va, vb, compare);
+    if(compare == NULL || !internal_vector_setReserve(vdest, vector_length(va))) {
+	return;
+    }
+
+    size_t na = vector_length(va), nb = vector_length(vb);
+    size_t i = 0, j = 0;
+    if(internal_vector_setIsUneven(va, vb) && na < nb) {
+	// look every element of va up in vb
+	for(; i < na && j < nb; i++) {
+	    const void* key = internal_vector_setAt(va, i);
+	    j = internal_vector_setGallop(vb, j, key, false, compare);
+	    if(j < nb && compare(internal_vector_setAt(vb, j), key) == 0) {
+		j++;
+	    } else {
+		internal_vector_setEmit(vdest, va, i, 1);
+	    }
+	}
+    } else if(internal_vector_setIsUneven(va, vb)) {
+	// copy the runs of va between elements of vb in bulk
+	for(; j < nb && i < na; j++) {
+	    const void* key = internal_vector_setAt(vb, j);
+	    size_t k = internal_vector_setGallop(va, i, key, false, compare);
+	    internal_vector_setEmit(vdest, va, i, k - i);
+	    i = (k < na && compare(internal_vector_setAt(va, k), key) == 0) ? (k+1) : (k);
+	}
+    } else {
+	while(i < na && j < nb) {
+	    int order = compare(internal_vector_setAt(va, i), internal_vector_setAt(vb, j));
+	    if(order < 0) {
+		internal_vector_setEmit(vdest, va, i++, 1);
+	    } else if(order > 0) {
+		j++;
+	    } else {
+		i++;
+		j++;
+	    }
+	}
+    }
+
+    internal_vector_setEmit(vdest, va, i, na - i);
+}
+
+/* ****** PRIVATE VECTOR SET METHODS FOR INTERNAL USE ONLY ****** */
+
+static vector_setCompare internal_vector_setResolve(vector* v, vector_setCompare compare) {
+    if(compare != NULL) {
+	return compare;
+    }
+
+    if(v->elementSize == sizeof(uint32_t)) {
+	return internal_vector_setCompareU32;
+    }
+
+    if(v->elementSize == sizeof(uint64_t)) {
+	return internal_vector_setCompareU64;
+    }
+
+    v->status = vectorStatus_error_incompatibleTypes;
+    return NULL;
+}
+
+static vector_setCompare internal_vector_setPrepare(vector* vdest, const vector* va, const vector* vb, vector_setCompare compare) {
+    if(vdest == NULL) {
+	return NULL;
+    }
+
+    if(va == NULL || vb == NULL || vdest == va || vdest == vb || vector_getHead(vdest) == NULL || vector_getHead(va) == NULL || vector_getHead(vb) == NULL) {
+	vdest->status = vectorStatus_error_operation;
+	return NULL;
+    }
+
+    // the walks read the raw elements, dead ones would show up in the result
+    if(vector_deadCount(va) > 0 || vector_deadCount(vb) > 0) {
+	vdest->status = vectorStatus_error_operation;
+	return NULL;
+    }
+
+    if(va->elementSize != vb->elementSize || vdest->elementSize != va->elementSize) {
+	vdest->status = vectorStatus_error_incompatibleTypes;
+	return NULL;
+    }
+
+    compare = internal_vector_setResolve(vdest, compare);
+    if(compare == NULL) {
+	return NULL;
+    }
+
+    internal_vector_setTruncate(vdest, 0);
+    vdest->status = vectorStatus_success;
+    return compare;
+}
+
+static bool internal_vector_setReserve(vector* vdest, const size_t bound) {
+    if(vector_capacity(vdest) < bound) {
+	vector_reserve(vdest, bound - vector_capacity(vdest));
+	if(vector_capacity(vdest) < bound) {
+	    vdest->status = vectorStatus_error_resize;
+	    return false;
+	}
+    }
+
+    return true;
+}
+
+static void internal_vector_setTruncate(vector* v, const size_t length) {
+    // let vector_pop clear the tombstones
+    while(vector_deadCount(v) > 0 && vector_length(v) > length) {
+	vector_pop(v);
+    }
+
+    // the contents change, so a compaction pass in progress is restarted
+    v->length = length;
+    v->compactRead = v->compactWrite = 0;
+}
+
+static const void* internal_vector_setAt(const vector* v, const size_t index) {
+    return ((const uint8_t*)v->data + index * v->elementSize);
+}
+
+static void internal_vector_setEmit(vector* vdest, const vector* vsrc, const size_t index, const size_t count) {
+    if(count == 0) {
+	return;
+    }
+
+    memcpy((uint8_t*)vdest->data + vdest->length * vdest->elementSize, internal_vector_setAt(vsrc, index), count * vsrc->elementSize);
+    vdest->length += count;
+}
+
+static size_t internal_vector_setGallop(const vector* v, const size_t from, const void* key, const bool upper, vector_setCompare compare) {
+    size_t length = vector_length(v);
+    size_t low = from, high = from, step = 1;
+
+    // exponential search for a range [low, high) holding the answer
+    while(high < length) {
+	int order = compare(internal_vector_setAt(v, high), key);
+	if(order > 0 || (order == 0 && !upper)) {
+	    break;
+	}
+
+	low = high + 1;
+	high += step;
+	step *= 2;
+    }
+
+    if(high > length) {
+	high = length;
+    }
+
+    // binary search inside it
+    while(low < high) {
+	size_t mid = low + (high - low) / 2;
+	int order = compare(internal_vector_setAt(v, mid), key);
+	if(order < 0 || (order == 0 && upper)) {
+	    low = mid + 1;
+	} else {
+	    high = mid;
+	}
+    }
+
+    return low;
+}
+
+static bool internal_vector_setIsUneven(const vector* va, const vector* vb) {
+    size_t na = vector_length(va), nb = vector_length(vb);
+    return (na / VECTOR_SET_GALLOP_RATIO > nb || nb / VECTOR_SET_GALLOP_RATIO > na);
+}
+
+static int internal_vector_setCompareU32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static int internal_vector_setCompareU64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void internal_vector_setIntersectU32(vector* vdest, const vector* va, const vector* vb) {
+    const uint32_t* a = vector_getHead(va);
+    const uint32_t* b = vector_getHead(vb);
+    uint32_t* out = (uint32_t*)vdest->data + vdest->length;
+    size_t na = vector_length(va), nb = vector_length(vb);
+    size_t i = 0, j = 0, k = 0;
+
+#if defined(__SSE2__)
+    // compare blocks of 4 against each other in all 4 rotations, then advance the block with the smaller maximum
+    while(i + 4 <= na && j + 4 <= nb) {
+	__m128i blockA = _mm_loadu_si128((const __m128i*)(a + i));
+	__m128i blockB = _mm_loadu_si128((const __m128i*)(b + j));
+	__m128i match = _mm_cmpeq_epi32(blockA, blockB);
+	match = _mm_or_si128(match, _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1))));
+	match = _mm_or_si128(match, _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(1, 0, 3, 2))));
+	match = _mm_or_si128(match, _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(2, 1, 0, 3))));
+
+	for(int mask = _mm_movemask_ps(_mm_castsi128_ps(match)); mask != 0; mask &= mask - 1) {
+	    out[k++] = a[i + __builtin_ctz(mask)];
+	}
+
+	uint32_t lastA = a[i + 3], lastB = b[j + 3];
+	i += (lastA <= lastB) ? (4) : (0);
+	j += (lastB <= lastA) ? (4) : (0);
+    }
+#endif
+
+    while(i < na && j < nb) {
+	if(a[i] < b[j]) {
+	    i++;
+	} else if(a[i] > b[j]) {
+	    j++;
+	} else {
+	    out[k++] = a[i++];
+	    j++;
+	}
+    }
+
+    vdest->length += k;
+}
+
+static void internal_vector_setIntersectU64(vector* vdest, const vector* va, const vector* vb) {
+    const uint64_t* a = vector_getHead(va);
+    const uint64_t* b = vector_getHead(vb);
+    uint64_t* out = (uint64_t*)vdest->data + vdest->length;
+    size_t na = vector_length(va), nb = vector_length(vb);
+    size_t i = 0, j = 0, k = 0;
+
+#if defined(__AVX2__)
+    // same block scheme as internal_vector_setIntersectU32, 4 lanes of 64 bits
+    while(i + 4 <= na && j + 4 <= nb) {
+	__m256i blockA = _mm256_loadu_si256((const __m256i*)(a + i));
+	__m256i blockB = _mm256_loadu_si256((const __m256i*)(b + j));
+	__m256i match = _mm256_cmpeq_epi64(blockA, blockB);
+	match = _mm256_or_si256(match, _mm256_cmpeq_epi64(blockA, _mm256_permute4x64_epi64(blockB, _MM_SHUFFLE(0, 3, 2, 1))));
+	match = _mm256_or_si256(match, _mm256_cmpeq_epi64(blockA, _mm256_permute4x64_epi64(blockB, _MM_SHUFFLE(1, 0, 3, 2))));
+	match = _mm256_or_si256(match, _mm256_cmpeq_epi64(blockA, _mm256_permute4x64_epi64(blockB, _MM_SHUFFLE(2, 1, 0, 3))));
+
+	for(int mask = _mm256_movemask_pd(_mm256_castsi256_pd(match)); mask != 0; mask &= mask - 1) {
+	    out[k++] = a[i + __builtin_ctz(mask)];
+	}
+
+	uint64_t lastA = a[i + 3], lastB = b[j + 3];
+	i += (lastA <= lastB) ? (4) : (0);
+	j += (lastB <= lastA) ? (4) : (0);
+    }
+#elif defined(__SSE2__)
+    // SSE2 has no 64-bit compare: a lane matches when both of its 32-bit halves do, blocks of 2 in both rotations
+    while(i + 2 <= na && j + 2 <= nb) {
+	__m128i blockA = _mm_loadu_si128((const __m128i*)(a + i));
+	__m128i blockB = _mm_loadu_si128((const __m128i*)(b + j));
+	__m128i match = _mm_cmpeq_epi32(blockA, blockB);
+	__m128i swapped = _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(1, 0, 3, 2)));
+	match = _mm_and_si128(match, _mm_shuffle_epi32(match, _MM_SHUFFLE(2, 3, 0, 1)));
+	swapped = _mm_and_si128(swapped, _mm_shuffle_epi32(swapped, _MM_SHUFFLE(2, 3, 0, 1)));
+	match = _mm_or_si128(match, swapped);
+
+	for(int mask = _mm_movemask_pd(_mm_castsi128_pd(match)); mask != 0; mask &= mask - 1) {
+	    out[k++] = a[i + __builtin_ctz(mask)];
+	}
+
+	uint64_t lastA = a[i + 1], lastB = b[j + 1];
+	i += (lastA <= lastB) ? (2) : (0);
+	j += (lastB <= lastA) ? (2) : (0);
+    }
+#endif
+
+    while(i < na && j < nb) {
+	if(a[i] < b[j]) {
+	    i++;
+	} else if(a[i] > b[j]) {
+	    j++;
+	} else {
+	    out[k++] = a[i++];
+	    j++;
+	}
+    }
+
+    vdest->length += k;
+}
+
+
+
+
+
+
+
+
@@ -0,0 +1,196 @@
+#ifndef VECTOR_SET_H
+#define VECTOR_SET_H
+
+/****** VECTOR SET ******
+ * Algebra over sorted vectors. Inputs must be sorted in ascending order; vector_setUnion,
+ * vector_setIntersect and vector_setDifference also expect them without duplicates (see vector_unique).
+ * The result replaces the contents of vdest, which is reallocated only if its capacity is too small,
+ * so the same vdest can be reused across calls. vdest must not be one of the inputs.
+ * Inputs must not contain dead elements (see vector_compactStep); vdest may, they are discarded.
+ *
+ * Pass compare = NULL to compare 4- or 8-byte elements as unsigned integers (uint32_t/uint64_t);
+ * this also enables the SIMD block intersection (SSE2 for 4-byte keys; AVX2, or SSE2 two lanes at a time, for 8-byte keys).
+ * When one input is more than VECTOR_SET_GALLOP_RATIO times longer than the other, the functions
+ * walk the shorter one and gallop (exponential search) through the longer one.
+ *
+ * public vector set functions + macros(e.g. (m)vector_merge, etc...):
+ *  - vector_merge
+ *  - vector_unique
+ *  - vector_setUnion
+ *  - vector_setIntersect
+ *  - vector_setDifference
+ *
+ * private vector set functions:
+ *  - internal_vector_setResolve
+ *  - internal_vector_setPrepare
+ *  - internal_vector_setReserve
+ *  - internal_vector_setTruncate
+ *  - internal_vector_setAt
+ *  - internal_vector_setEmit
+ *  - internal_vector_setGallop
+ *  - internal_vector_setIsUneven
+ *  - internal_vector_setCompareU32
+ *  - internal_vector_setCompareU64
+ *  - internal_vector_setIntersectU32
+ *  - internal_vector_setIntersectU64
+*/
+
+#include "vector.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VECTOR_SET_GALLOP_RATIO 32
+
+/* ****** MACROS ****** */
+
+#define mvector_merge(v, a, b, compare) vector_merge(&v, &a, &b, compare)
+#define mvector_unique(v, compare) vector_unique(&v, compare)
+#define mvector_setUnion(v, a, b, compare) vector_setUnion(&v, &a, &b, compare)
+#define mvector_setIntersect(v, a, b, compare) vector_setIntersect(&v, &a, &b, compare)
+#define mvector_setDifference(v, a, b, compare) vector_setDifference(&v, &a, &b, compare)
+
+/* ****** VECTOR SET STRUCTURES ****** */
+
+// element comparison: negative if a < b, 0 if equal, positive if a > b (same as qsort)
+typedef int (*vector_setCompare)(const void* a, const void* b);
+
+/* ****** PUBLIC VECTOR SET METHODS ****** */
+
+/* merges two sorted vectors into vdest, keeping duplicates (elements of va come first among equal ones)
+ *  params:
+ *	vector* vdest              => destination vector
+ *	vector* va                 => sorted vector
+ *	vector* vb                 => sorted vector
+ *	vector_setCompare compare  => comparison function or NULL
+*/
+void vector_merge(vector* vdest, const vector* va, const vector* vb, vector_setCompare compare);
+
+/* removes adjacent duplicates in place (a sorted vector becomes a set), does not realloc the vector; v must not contain dead elements
+ *  params:
+ *	vector* v                  => vector instance
+ *	vector_setCompare compare  => comparison function or NULL
+*/
+void vector_unique(vector* v, vector_setCompare compare);
+
+/* stores elements present in va or vb into vdest
+ *  params:
+ *	vector* vdest              => destination vector
+ *	vector* va                 => sorted set
+ *	vector* vb                 => sorted set
+ *	vector_setCompare compare  => comparison function or NULL
+*/
+void vector_setUnion(vector* vdest, const vector* va, const vector* vb, vector_setCompare compare);
+
+/* stores elements present in both va and vb into vdest
+ *  params:
+ *	vector* vdest              => destination vector
+ *	vector* va                 => sorted set
+ *	vector* vb                 => sorted set
+ *	vector_setCompare compare  => comparison function or NULL
+*/
+void vector_setIntersect(vector* vdest, const vector* va, const vector* vb, vector_setCompare compare);
+
+/* stores elements of va that are not in vb into vdest
+ *  params:
+ *	vector* vdest              => destination vector
+ *	vector* va                 => sorted set
+ *	vector* vb                 => sorted set
+ *	vector_setCompare compare  => comparison function or NULL
+*/
+void vector_setDifference(vector* vdest, const vector* va, const vector* vb, vector_setCompare compare);
+
+/* ****** PRIVATE VECTOR SET METHODS FOR INTERNAL USE ONLY ****** */
+
+/* returns the comparison function to use (the uint32_t/uint64_t one if compare is NULL) or NULL on failure (v status is set)
+ *  params:
+ *	vector* v                  => vector instance
+ *	vector_setCompare compare  => comparison function or NULL
+*/
+static vector_setCompare internal_vector_setResolve(vector* v, vector_setCompare compare);
+
+/* validates the operands and empties vdest; returns the comparison function to use or NULL on failure (vdest status is set)
+ *  params:
+ *	vector* vdest              => destination vector
+ *	vector* va, vb             => input vectors
+ *	vector_setCompare compare  => comparison function or NULL
+*/
+static vector_setCompare internal_vector_setPrepare(vector* vdest, const vector* va, const vector* vb, vector_setCompare compare);
+
+/* makes room for bound elements in vdest; returns false on failure (vdest status is set)
+ *  params:
+ *	vector* vdest => destination vector
+ *	size_t bound  => maximum number of result elements
+*/
+static bool internal_vector_setReserve(vector* vdest, const size_t bound);
+
+/* reduces vector length without touching its capacity
+ *  params:
+ *	vector* v     => vector instance
+ *	size_t length => new vector length
+*/
+static void internal_vector_setTruncate(vector* v, const size_t length);
+
+/* returns a pointer to the element at an index (no bounds checking)
+ *  params:
+ *	vector* v    => vector instance
+ *	size_t index => index
+*/
+static const void* internal_vector_setAt(const vector* v, const size_t index);
+
+/* appends count elements from vsrc starting at index to vdest (capacity must already be reserved)
+ *  params:
+ *	vector* vdest => destination vector
+ *	vector* vsrc  => source vector
+ *	size_t index  => first element to copy
+ *	size_t count  => number of elements to copy
+*/
+static void internal_vector_setEmit(vector* vdest, const vector* vsrc, const size_t index, const size_t count);
+
+/* returns the first index at or after from whose element is not less than key (or greater than key if upper is set),
+ * found by exponential search followed by binary search
+ *  params:
+ *	vector* v                  => sorted vector
+ *	size_t from                => index to start searching from
+ *	void* key                  => element to look for
+ *	bool upper                 => skip elements equal to key as well
+ *	vector_setCompare compare  => comparison function
+*/
+static size_t internal_vector_setGallop(const vector* v, const size_t from, const void* key, const bool upper, vector_setCompare compare);
+
+/* returns true if one vector is more than VECTOR_SET_GALLOP_RATIO times longer than the other
+ *  params:
+ *	vector* va, vb => input vectors
+*/
+static bool internal_vector_setIsUneven(const vector* va, const vector* vb);
+
+/* compares two uint32_t/uint64_t elements
+ *  params:
+ *	void* a, void* b => elements to compare
+*/
+static int internal_vector_setCompareU32(const void* a, const void* b);
+static int internal_vector_setCompareU64(const void* a, const void* b);
+
+/* intersects two sorted sets of uint32_t/uint64_t with SIMD block comparisons, appending the result to vdest
+ *  params:
+ *	vector* vdest  => destination vector (capacity must already be reserved)
+ *	vector* va, vb => sorted sets
+*/
+static void internal_vector_setIntersectU32(vector* vdest, const vector* va, const vector* vb);
+static void internal_vector_setIntersectU64(vector* vdest, const vector* va, const vector* vb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VECTOR_SET_H
+
+
+
+
+
+
+
+
+
@@ -0,0 +1,311 @@
+#include "vector_strings.h"
+
+/* Documentation: READ vector_strings.h */
+
+/* ****** PUBLIC VECTOR STRINGS METHODS ****** */
+
+void vector_stringsCreate(vector_strings* s) {
+    s->interning = false;
+    s->indexValid = false;
+    s->garbage = 0;
+
+    vector_create(&s->bytes, sizeof(char));
+    vector_create(&s->entries, sizeof(vector_stringEntry));
+    vector_create(&s->index, sizeof(uint32_t));
+
+    if(vector_status_code(&s->bytes) != vectorStatus_success || vector_status_code(&s->entries) != vectorStatus_success || vector_status_code(&s->index) != vectorStatus_success) {
+	vector_stringsFree(s);
+	s->status = vectorStatus_error_init;
+	return;
+    }
+
+    s->status = vectorStatus_success;
+}
+
+void vector_stringsFree(vector_strings* s) {
+    vector_free(&s->bytes);
+    vector_free(&s->entries);
+    vector_free(&s->index);
+
+    s->interning = s->indexValid = false;
+    s->garbage = 0;
+    s->status = vectorStatus_freed;
+}
+
+void vector_stringsPush(vector_strings* s, const char* str, const size_t length) {
+    vector_stringsPushArr(s, &str, &length, 1);
+}
+
+void vector_stringsPushStr(vector_strings* s, const char* str) {
+    vector_stringsPushArr(s, &str, NULL, 1);
+}
+
+void vector_stringsPushArr(vector_strings* s, const char* const* strs, const size_t* lengths, const size_t count) {
+    if(strs == NULL || vector_getHead(&s->bytes) == NULL || vector_getHead(&s->entries) == NULL) {
+	s->status = vectorStatus_error_null;
+	return;
+    }
+
+    if(count >= UINT32_MAX - vector_length(&s->entries)) {
+	s->status = vectorStatus_error_operation;
+	return;
+    }
+
+    // the new entries are built in the spare capacity, only the lengths change until validation passes
+    if(!internal_vector_stringsReserve(&s->entries, count)) {
+	s->status = vectorStatus_error_resize;
+	return;
+    }
+
+    // validate everything first, so a failure leaves the pool untouched; each string is scanned once
+    vector_stringEntry* entries = (vector_stringEntry*)vector_getHead(&s->entries) + vector_length(&s->entries);
+    size_t total = 0;
+    for(size_t i = 0; i < count; i++) {
+	if(strs[i] == NULL && (lengths == NULL || lengths[i] > 0)) {
+	    s->status = vectorStatus_error_null;
+	    return;
+	}
+
+	size_t length = (lengths != NULL) ? (lengths[i]) : (strlen(strs[i]));
+	entries[i].length = (uint32_t)length;
+	total += length;
+    }
+
+    if(total > UINT32_MAX - vector_length(&s->bytes)) {
+	s->status = vectorStatus_error_operation;
+	return;
+    }
+
+    // strings may point into the arena (views of this pool), which the reserve below may move
+    uintptr_t arena = (uintptr_t)vector_getHead(&s->bytes);
+    size_t arenaLength = vector_length(&s->bytes);
+
+    if(!internal_vector_stringsReserve(&s->bytes, total)) {
+	s->status = vectorStatus_error_resize;
+	return;
+    }
+
+    char* bytes = vector_getHead(&s->bytes);
+    for(size_t i = 0; i < count; i++) {
+	const char* str = strs[i];
+	if((uintptr_t)str >= arena && (uintptr_t)str < arena + arenaLength) {
+	    str = bytes + ((uintptr_t)str - arena);
+	}
+
+	entries[i].offset = (uint32_t)s->bytes.length;
+	if(entries[i].length > 0) {
+	    memcpy(bytes + entries[i].offset, str, entries[i].length);
+	}
+
+	s->bytes.length += entries[i].length;
+	s->entries.length++;
+
+	if(s->interning && s->indexValid && !internal_vector_stringsIndexInsert(s, s->entries.length-1)) {
+	    // rebuilt on the next lookup
+	    s->indexValid = false;
+	}
+    }
+
+    s->status = vectorStatus_success;
+}
+
+void vector_stringsRemove(vector_strings* s, const size_t index) {
+    if(index >= vector_length(&s->entries)) {
+	s->status = vectorStatus_error_elementDoesntExist;
+	return;
+    }
+
+    vector_stringEntry* entries = vector_getHead(&s->entries);
+    s->garbage += entries[index].length;
+    memmove(entries + index, entries + index + 1, (vector_length(&s->entries) - index - 1) * sizeof(vector_stringEntry));
+    vector_pop(&s->entries);
+
+    // entry indices after index have shifted
+    s->indexValid = false;
+    s->status = vectorStatus_success;
+}
+
+void vector_stringsClear(vector_strings* s) {
+    s->bytes.length = 0;
+    s->entries.length = 0;
+    s->garbage = 0;
+    s->indexValid = false;
+    s->status = vectorStatus_success;
+}
+
+void vector_stringsCompact(vector_strings* s) {
+    if(s->garbage == 0) {
+	return;
+    }
+
+    // entries are kept in arena order, so every string moves down (or stays)
+    char* bytes = vector_getHead(&s->bytes);
+    vector_stringEntry* entries = vector_getHead(&s->entries);
+    uint32_t offset = 0;
+    for(size_t i = 0; i < vector_length(&s->entries); i++) {
+	if(entries[i].offset != offset) {
+	    memmove(bytes + offset, bytes + entries[i].offset, entries[i].length);
+	    entries[i].offset = offset;
+	}
+	offset += entries[i].length;
+    }
+
+    s->bytes.length = offset;
+    s->garbage = 0;
+    s->status = vectorStatus_success;
+}
+
+vector_stringView vector_stringsGet(vector_strings* s, const size_t index) {
+    vector_stringView view = { NULL, 0 };
+    if(index >= vector_length(&s->entries)) {
+	s->status = vectorStatus_error_elementDoesntExist;
+	return view;
+    }
+
+    const vector_stringEntry* entry = (const vector_stringEntry*)vector_getHead(&s->entries) + index;
+    view.data = (const char*)vector_getHead(&s->bytes) + entry->offset;
+    view.length = entry->length;
+    return view;
+}
+
+size_t vector_stringsIntern(vector_strings* s, const char* str, const size_t length) {
+    size_t index = vector_stringsFind(s, str, length);
+    if(index < vector_stringsLength(s) || s->status != vectorStatus_success) {
+	return index;
+    }
+
+    vector_stringsPush(s, str, length);
+    return (s->status == vectorStatus_success) ? (vector_stringsLength(s) - 1) : (vector_stringsLength(s));
+}
+
+size_t vector_stringsFind(vector_strings* s, const char* str, const size_t length) {
+    if(str == NULL && length > 0) {
+	s->status = vectorStatus_error_null;
+	return vector_stringsLength(s);
+    }
+
+    if(!s->interning || !s->indexValid) {
+	if(!internal_vector_stringsIndexBuild(s, 0)) {
+	    s->status = vectorStatus_error_resize;
+	    return vector_stringsLength(s);
+	}
+	s->interning = true;
+    }
+
+    uint32_t slot = ((const uint32_t*)vector_getHead(&s->index))[internal_vector_stringsSlot(s, str, length)];
+    s->status = vectorStatus_success;
+    return (slot != 0) ? (slot - 1) : (vector_stringsLength(s));
+}
+
+size_t vector_stringsLength(const vector_strings* s) {
+    return vector_length(&s->entries);
+}
+
+size_t vector_stringsGarbage(const vector_strings* s) {
+    return s->garbage;
+}
+
+size_t vector_stringsMemory(const vector_strings* s) {
+    return (vector_memory(&s->bytes) + vector_memory(&s->entries) + vector_memory(&s->index));
+}
+
+vectorStatus vector_stringsStatus(const vector_strings* s) {
+    return s->status;
+}
+
+/* ****** PRIVATE VECTOR STRINGS METHODS FOR INTERNAL USE ONLY ****** */
+
+static bool internal_vector_stringsReserve(vector* v, const size_t count) {
+    size_t available = vector_availableSpace(v);
+    if(available >= count) {
+	return true;
+    }
+
+    size_t grow = count - available;
+    size_t growth = vector_capacity(v) * (VECTOR_GROWTH_RATE - 1);
+    vector_reserve(v, (grow > growth) ? (grow) : (growth));
+
+    return (vector_availableSpace(v) >= count);
+}
+
+static uint64_t internal_vector_stringsHash(const char* str, const size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    for(size_t i = 0; i < length; i++) {
+	hash ^= (uint8_t)str[i];
+	hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static bool internal_vector_stringsEqual(const vector_strings* s, const size_t index, const char* str, const size_t length) {
+    const vector_stringEntry* entry = (const vector_stringEntry*)vector_getHead(&s->entries) + index;
+    return (entry->length == length && (length == 0 || memcmp((const char*)vector_getHead(&s->bytes) + entry->offset, str, length) == 0));
+}
+
+static size_t internal_vector_stringsSlot(const vector_strings* s, const char* str, const size_t length) {
+    // linear probing, the table size is a power of 2
+    const uint32_t* table = vector_getHead(&s->index);
+    size_t mask = vector_length(&s->index) - 1;
+    size_t slot = internal_vector_stringsHash(str, length) & mask;
+    while(table[slot] != 0 && !internal_vector_stringsEqual(s, table[slot] - 1, str, length)) {
+	slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+static bool internal_vector_stringsIndexInsert(vector_strings* s, const size_t index) {
+    // keep the load factor at or below 1/2
+    if(vector_length(&s->entries) * 2 > vector_length(&s->index)) {
+	return internal_vector_stringsIndexBuild(s, vector_length(&s->index) * 2);
+    }
+
+    vector_stringView view = vector_stringsGet(s, index);
+    uint32_t* table = vector_getHead(&s->index);
+    size_t slot = internal_vector_stringsSlot(s, view.data, view.length);
+    if(table[slot] == 0) {
+	table[slot] = (uint32_t)(index + 1);
+    }
+
+    return true;
+}
+
+static bool internal_vector_stringsIndexBuild(vector_strings* s, const size_t slots) {
+    size_t size = VECTOR_STRINGS_INDEX_INIT_SLOTS;
+    while(size < slots || size < (vector_length(&s->entries) + 1) * 2) {
+	size *= 2;
+    }
+
+    s->indexValid = false;
+    if(vector_capacity(&s->index) < size) {
+	vector_setLength(&s->index, size);
+	if(vector_capacity(&s->index) < size) {
+	    return false;
+	}
+    }
+
+    s->index.length = size;
+    memset(vector_getHead(&s->index), 0, size * sizeof(uint32_t));
+
+    // the first of several equal strings wins
+    uint32_t* table = vector_getHead(&s->index);
+    for(size_t i = 0; i < vector_length(&s->entries); i++) {
+	vector_stringView view = vector_stringsGet(s, i);
+	size_t slot = internal_vector_stringsSlot(s, view.data, view.length);
+	if(table[slot] == 0) {
+	    table[slot] = (uint32_t)(i + 1);
+	}
+    }
+
+    s->indexValid = true;
+    return true;
+}
+
+
+
+
+
+
+
+
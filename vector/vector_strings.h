@@ -0,0 +1,254 @@
+#ifndef VECTOR_STRINGS_H
+#define VECTOR_STRINGS_H
+
+/****** VECTOR STRINGS ******
+ * A vector of variable-length strings stored back to back in one byte arena (a vector of char)
+ * plus one 8-byte entry per string (offset + length) instead of a malloc'ed block and a pointer
+ * per string. Strings are handed out as zero-copy views, which stay valid until the next push or
+ * compaction. Removed strings leave garbage in the arena until vector_stringsCompact is called.
+ * An optional interning index (built on the first vector_stringsIntern/vector_stringsFind) deduplicates strings.
+ * The arena is limited to 4 GiB (UINT32_MAX bytes).
+ *
+ * public vector strings functions + macros(e.g. (m)vector_stringsCreate, etc...):
+ *  - vector_stringsCreate
+ *  - vector_stringsFree
+ *  - vector_stringsPush
+ *  - vector_stringsPushStr
+ *  - vector_stringsPushArr
+ *  - vector_stringsRemove
+ *  - vector_stringsClear
+ *  - vector_stringsCompact
+ *  - vector_stringsGet
+ *  - vector_stringsIntern
+ *  - vector_stringsFind
+ *  - vector_stringsLength
+ *  - vector_stringsGarbage
+ *  - vector_stringsMemory
+ *  - vector_stringsStatus
+ *
+ * private vector strings functions:
+ *  - internal_vector_stringsReserve
+ *  - internal_vector_stringsHash
+ *  - internal_vector_stringsEqual
+ *  - internal_vector_stringsSlot
+ *  - internal_vector_stringsIndexInsert
+ *  - internal_vector_stringsIndexBuild
+*/
+
+#include "vector.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VECTOR_STRINGS_INDEX_INIT_SLOTS 16
+
+/* ****** MACROS ****** */
+
+#define mvector_stringsCreate(s) vector_strings s; vector_stringsCreate(&s)
+#define mvector_stringsFree(s) vector_stringsFree(&s)
+#define mvector_stringsPush(s, str, length) vector_stringsPush(&s, str, length)
+#define mvector_stringsPushStr(s, str) vector_stringsPushStr(&s, str)
+#define mvector_stringsPushArr(s, strs, lengths, count) vector_stringsPushArr(&s, strs, lengths, count)
+#define mvector_stringsRemove(s, index) vector_stringsRemove(&s, index)
+#define mvector_stringsClear(s) vector_stringsClear(&s)
+#define mvector_stringsCompact(s) vector_stringsCompact(&s)
+#define mvector_stringsGet(s, index) vector_stringsGet(&s, index)
+#define mvector_stringsIntern(s, str, length) vector_stringsIntern(&s, str, length)
+#define mvector_stringsFind(s, str, length) vector_stringsFind(&s, str, length)
+#define mvector_stringsLength(s) vector_stringsLength(&s)
+#define mvector_stringsGarbage(s) vector_stringsGarbage(&s)
+#define mvector_stringsMemory(s) vector_stringsMemory(&s)
+#define mvector_stringsStatus(s) vector_stringsStatus(&s)
+
+/* ****** VECTOR STRINGS STRUCTURES ****** */
+
+// zero-copy string view (not NUL-terminated, print with "%.*s")
+typedef struct vector_stringView {
+    const char* data;  // first byte, NULL if the string does not exist
+    size_t length;     // number of bytes
+} vector_stringView;
+
+// location of a string in the arena
+typedef struct vector_stringEntry {
+    uint32_t offset;  // first byte in the arena
+    uint32_t length;  // number of bytes
+} vector_stringEntry;
+
+// contiguous string pool data structure
+typedef struct vector_strings {
+    vector bytes;         // arena: all string bytes back to back
+    vector entries;       // vector_stringEntry per string, in order
+    vector index;         // interning hash table: entry index + 1 per slot, 0 if empty (unused until the first intern)
+    bool interning;       // the index is maintained on every push
+    bool indexValid;      // the index matches entries (removals invalidate it)
+    size_t garbage;       // arena bytes of removed strings
+    vectorStatus status;  // status of the last operation
+} vector_strings;
+
+/* ****** PUBLIC VECTOR STRINGS METHODS ****** */
+
+/* initializes a string pool
+ *  params:
+ *	vector_strings* s => vector_strings instance
+*/
+void vector_stringsCreate(vector_strings* s);
+
+/* frees string pool memory
+ *  params:
+ *	vector_strings* s => vector_strings instance
+*/
+void vector_stringsFree(vector_strings* s);
+
+/* pushes a string of length bytes at the end (may contain NUL bytes); str may be a view of this pool
+ *  params:
+ *	vector_strings* s => vector_strings instance
+ *	char* str         => string bytes
+ *	size_t length     => number of bytes
+*/
+void vector_stringsPush(vector_strings* s, const char* str, const size_t length);
+
+/* pushes a NUL-terminated string at the end
+ *  params:
+ *	vector_strings* s => vector_strings instance
+ *	char* str         => NUL-terminated string
+*/
+void vector_stringsPushStr(vector_strings* s, const char* str);
+
+/* pushes count strings at the end, growing the arena and the entries at most once; strs may be views of this pool
+ *  params:
+ *	vector_strings* s => vector_strings instance
+ *	char** strs       => strings
+ *	size_t* lengths   => string lengths, or NULL if strs are NUL-terminated
+ *	size_t count      => number of strings
+*/
+void vector_stringsPushArr(vector_strings* s, const char* const* strs, const size_t* lengths, const size_t count);
+
+/* removes a string at an index (order is preserved, its bytes stay in the arena until vector_stringsCompact)
+ *  params:
+ *	vector_strings* s => vector_strings instance
+ *	size_t index      => index
+*/
+void vector_stringsRemove(vector_strings* s, const size_t index);
+
+/* removes all strings (does not realloc)
+ *  params:
+ *	vector_strings* s => vector_strings instance
+*/
+void vector_stringsClear(vector_strings* s);
+
+/* moves the remaining strings together, dropping the bytes of removed ones (does not realloc)
+ *  params:
+ *	vector_strings* s => vector_strings instance
+*/
+void vector_stringsCompact(vector_strings* s);
+
+/* returns a view of the string at an index ({NULL, 0} if it does not exist)
+ *  params:
+ *	vector_strings* s => vector_strings instance
+ *	size_t index      => index
+*/
+vector_stringView vector_stringsGet(vector_strings* s, const size_t index);
+
+/* returns the index of a string equal to str, pushing it first if there is none
+ * (the interning index is built on the first call and maintained from then on)
+ *  params:
+ *	vector_strings* s => vector_strings instance
+ *	char* str         => string bytes
+ *	size_t length     => number of bytes
+*/
+size_t vector_stringsIntern(vector_strings* s, const char* str, const size_t length);
+
+/* returns the index of a string equal to str, or vector_stringsLength if there is none (uses the interning index)
+ *  params:
+ *	vector_strings* s => vector_strings instance
+ *	char* str         => string bytes
+ *	size_t length     => number of bytes
+*/
+size_t vector_stringsFind(vector_strings* s, const char* str, const size_t length);
+
+/* returns the number of strings
+ *  params:
+ *	vector_strings* s => vector_strings instance
+*/
+size_t vector_stringsLength(const vector_strings* s);
+
+/* returns the number of arena bytes held by removed strings
+ *  params:
+ *	vector_strings* s => vector_strings instance
+*/
+size_t vector_stringsGarbage(const vector_strings* s);
+
+/* returns allocated memory in bytes (arena + entries + interning index)
+ *  params:
+ *	vector_strings* s => vector_strings instance
+*/
+size_t vector_stringsMemory(const vector_strings* s);
+
+/* returns the status of the last operation
+ *  params:
+ *	vector_strings* s => vector_strings instance
+*/
+vectorStatus vector_stringsStatus(const vector_strings* s);
+
+/* ****** PRIVATE VECTOR STRINGS METHODS FOR INTERNAL USE ONLY ****** */
+
+/* makes room for count more elements, growing by at least VECTOR_GROWTH_RATE; returns false on failure
+ *  params:
+ *	vector* v    => vector instance
+ *	size_t count => number of elements to make room for
+*/
+static bool internal_vector_stringsReserve(vector* v, const size_t count);
+
+/* returns the FNV-1a hash of a string
+ *  params:
+ *	char* str     => string bytes
+ *	size_t length => number of bytes
+*/
+static uint64_t internal_vector_stringsHash(const char* str, const size_t length);
+
+/* returns true if the string at an index equals str
+ *  params:
+ *	vector_strings* s => vector_strings instance
+ *	size_t index      => index
+ *	char* str         => string bytes
+ *	size_t length     => number of bytes
+*/
+static bool internal_vector_stringsEqual(const vector_strings* s, const size_t index, const char* str, const size_t length);
+
+/* returns the index slot holding a string equal to str, or the empty slot where it would go
+ *  params:
+ *	vector_strings* s => vector_strings instance
+ *	char* str         => string bytes
+ *	size_t length     => number of bytes
+*/
+static size_t internal_vector_stringsSlot(const vector_strings* s, const char* str, const size_t length);
+
+/* adds the string at an index to the interning index unless an equal one is there already; returns false on failure
+ *  params:
+ *	vector_strings* s => vector_strings instance
+ *	size_t index      => index
+*/
+static bool internal_vector_stringsIndexInsert(vector_strings* s, const size_t index);
+
+/* rebuilds the interning index with room for slots entries; returns false on failure
+ *  params:
+ *	vector_strings* s => vector_strings instance
+ *	size_t slots      => minimum number of slots
+*/
+static bool internal_vector_stringsIndexBuild(vector_strings* s, const size_t slots);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VECTOR_STRINGS_H
+
+
+
+
+
+
+
+
+